@@ -34,6 +34,11 @@
 #define OP_SHUTDOWN    12
 #define OP_DISPLAYTEST 15
 
+// Refresh steps: 5 control registers, then the 8 bitmap rows
+#define REFRESH_CONTROL_STEPS 5
+#define REFRESH_STEPS  (REFRESH_CONTROL_STEPS + 8)
+#define REFRESH_IDLE   0xff
+
 Max72xxPanel::Max72xxPanel(byte csPin, byte hDisplays, byte vDisplays) : Adafruit_GFX(hDisplays << 3, vDisplays << 3) {
 
   Max72xxPanel::SPI_CS = csPin;
@@ -51,6 +56,12 @@ Max72xxPanel::Max72xxPanel(byte csPin, byte hDisplays, byte vDisplays) : Adafrui
   	matrixRotation[display] = 0;
   }
 
+  // Nothing sent yet: the first write of every control register goes out
+  memset(controlShadow, 0xff, sizeof(controlShadow));
+  refreshInterval = 0;
+  lastRefresh = 0;
+  refreshIndex = REFRESH_IDLE;
+
   SPI.begin();
 //SPI.setBitOrder(MSBFIRST);
 //SPI.setDataMode(SPI_MODE0);
@@ -63,10 +74,10 @@ Max72xxPanel::Max72xxPanel(byte csPin, byte hDisplays, byte vDisplays) : Adafrui
   spiTransfer(OP_DISPLAYTEST, 0);
 
   // We need the multiplexer to scan all segments
-  spiTransfer(OP_SCANLIMIT, 7);
+  setControl(OP_SCANLIMIT, 7);
 
   // We don't want the multiplexer to decode segments for us
-  spiTransfer(OP_DECODEMODE, 0);
+  setControl(OP_DECODEMODE, 0);
 
   // Enable display
   shutdown(false);
@@ -88,11 +99,54 @@ void Max72xxPanel::setRotation(uint8_t rotation) {
 }
 
 void Max72xxPanel::shutdown(boolean b) {
-  spiTransfer(OP_SHUTDOWN, b ? 0 : 1);
+  setControl(OP_SHUTDOWN, b ? 0 : 1);
 }
 
 void Max72xxPanel::setIntensity(byte intensity) {
-  spiTransfer(OP_INTENSITY, intensity);
+  setControl(OP_INTENSITY, intensity);
+}
+
+void Max72xxPanel::setControl(byte opcode, byte data) {
+  byte *shadow = controlShadow + (opcode - OP_DECODEMODE);
+  if ( *shadow == data ) {
+    return;
+  }
+  *shadow = data;
+  spiTransfer(opcode, data);
+}
+
+void Max72xxPanel::setRefreshInterval(unsigned long interval) {
+  refreshInterval = interval;
+  lastRefresh = millis();
+  refreshIndex = REFRESH_IDLE;
+}
+
+void Max72xxPanel::refreshStep() {
+  if ( refreshInterval == 0 ) {
+    return;
+  }
+  if ( refreshIndex == REFRESH_IDLE ) {
+    if ( millis() - lastRefresh < refreshInterval ) {
+      return;
+    }
+    lastRefresh = millis();
+    refreshIndex = 0;
+  }
+
+  // Unconditional: the shadow says what the displays should hold, not what
+  // they actually hold after a glitch.
+  switch ( refreshIndex ) {
+    case 0: spiTransfer(OP_DISPLAYTEST, 0); break;
+    case 1: spiTransfer(OP_SCANLIMIT, controlShadow[OP_SCANLIMIT - OP_DECODEMODE]); break;
+    case 2: spiTransfer(OP_DECODEMODE, controlShadow[0]); break;
+    case 3: spiTransfer(OP_SHUTDOWN, controlShadow[OP_SHUTDOWN - OP_DECODEMODE]); break;
+    case 4: spiTransfer(OP_INTENSITY, controlShadow[OP_INTENSITY - OP_DECODEMODE]); break;
+    default: spiTransfer(OP_DIGIT0 + refreshIndex - REFRESH_CONTROL_STEPS); break;
+  }
+
+  if ( ++refreshIndex >= REFRESH_STEPS ) {
+    refreshIndex = REFRESH_IDLE;
+  }
 }
 
 void Max72xxPanel::fillScreen(uint16_t color) {
@@ -123,7 +177,7 @@ void Max72xxPanel::drawPixel(int16_t xx, int16_t yy, uint16_t color) {
 		}
 	}
 
-	if ( x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT ) {
+	if ( x < 0 || x >= WIDTH || y >= HEIGHT ) {		// y is a byte: negative rows wrap past HEIGHT
 		// Ignore pixels outside the canvas.
 		return;
 	}
@@ -163,6 +217,115 @@ void Max72xxPanel::drawPixel(int16_t xx, int16_t yy, uint16_t color) {
 	}
 }
 
+void Max72xxPanel::drawColumn(int16_t x, int16_t y, byte bits) {
+	if ( rotation || x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT || (y & 0b111) ) {
+		// Slow path: rotated canvas, clipping or a column straddling two displays.
+		for ( byte row = 0; row < 8; row++ ) {
+			drawPixel(x, y + row, (bits >> row) & 1);
+		}
+		return;
+	}
+
+	// Same translation as drawPixel(), done once for the whole column. The
+	// column lands on bitmap byte(s) of the display it falls in.
+	byte display = matrixPosition[(x >> 3) + hDisplays * (y >> 3)];
+	byte d = display / hDisplays;
+	byte *block = bitmap + ((display - d * hDisplays) << 3) + WIDTH * d;
+	byte cx = x & 0b111;
+
+	switch ( matrixRotation[display] ) {
+		case 0:			// Column maps to one byte, top pixel in bit 0
+			block[cx] = bits;
+			break;
+		case 2:			// One byte, upside down
+			{
+				byte reversed = 0;
+				for ( byte row = 0; row < 8; row++ ) {
+					reversed = (reversed << 1) | ((bits >> row) & 1);
+				}
+				block[7 - cx] = reversed;
+			}
+			break;
+		case 1:			// One bit in each of the 8 bytes, bottom pixel first
+			for ( byte row = 0; row < 8; row++ ) {
+				byte val = 1 << cx;
+				if ( (bits >> row) & 1 ) block[7 - row] |= val;
+				else block[7 - row] &= ~val;
+			}
+			break;
+		default:		// 3: one bit in each of the 8 bytes, top pixel first
+			for ( byte row = 0; row < 8; row++ ) {
+				byte val = 1 << (7 - cx);
+				if ( (bits >> row) & 1 ) block[row] |= val;
+				else block[row] &= ~val;
+			}
+			break;
+	}
+}
+
+// Transpose an 8x8 block of row bytes (bit 7 = leftmost pixel) into
+// column bytes (bit 0 = top pixel), with three rounds of bit swaps.
+static void transpose8(const byte *rows, byte *columns) {
+	uint32_t x = ((uint32_t)rows[7] << 24) | ((uint32_t)rows[6] << 16) | ((uint32_t)rows[5] << 8) | rows[4];
+	uint32_t y = ((uint32_t)rows[3] << 24) | ((uint32_t)rows[2] << 16) | ((uint32_t)rows[1] << 8) | rows[0];
+	uint32_t t;
+
+	t = (x ^ (x >> 7)) & 0x00AA00AA;  x = x ^ t ^ (t << 7);
+	t = (y ^ (y >> 7)) & 0x00AA00AA;  y = y ^ t ^ (t << 7);
+	t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+	t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+	t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+	y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+	x = t;
+
+	columns[0] = x >> 24; columns[1] = x >> 16; columns[2] = x >> 8; columns[3] = x;
+	columns[4] = y >> 24; columns[5] = y >> 16; columns[6] = y >> 8; columns[7] = y;
+}
+
+static byte reverseBits(byte b) {
+	b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
+	b = (b & 0xCC) >> 2 | (b & 0x33) << 2;
+	b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
+	return b;
+}
+
+void Max72xxPanel::drawRows(int16_t x, int16_t y, const byte *rows) {
+	if ( rotation || x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT || (x & 0b111) || (y & 0b111) ) {
+		// Slow path: rotated canvas, clipping or a block straddling two displays.
+		for ( byte row = 0; row < 8; row++ ) {
+			for ( byte col = 0; col < 8; col++ ) {
+				drawPixel(x + col, y + row, (rows[row] >> (7 - col)) & 1);
+			}
+		}
+		return;
+	}
+
+	byte display = matrixPosition[(x >> 3) + hDisplays * (y >> 3)];
+	byte d = display / hDisplays;
+	byte *block = bitmap + ((display - d * hDisplays) << 3) + WIDTH * d;
+	byte columns[8];
+
+	switch ( matrixRotation[display] ) {
+		case 3:			// Bitmap bytes are the rows
+			memcpy(block, rows, 8);
+			break;
+		case 1:			// Rows bottom up, pixels right to left
+			for ( byte row = 0; row < 8; row++ ) {
+				block[7 - row] = reverseBits(rows[row]);
+			}
+			break;
+		case 0:			// Bitmap bytes are the columns
+			transpose8(rows, block);
+			break;
+		default:		// 2: columns right to left, upside down
+			transpose8(rows, columns);
+			for ( byte col = 0; col < 8; col++ ) {
+				block[7 - col] = reverseBits(columns[col]);
+			}
+			break;
+	}
+}
+
 void Max72xxPanel::write() {
 	// Send the bitmap buffer to the displays.
 
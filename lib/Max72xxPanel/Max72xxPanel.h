@@ -71,6 +71,23 @@ public:
    */
   void drawPixel(int16_t x, int16_t y, uint16_t color);
 
+  /*
+   * Set the 8 pixels from (x, y) down to (x, y + 7) at once: bit 0 of
+   * bits is the top pixel, set bits are on and clear bits off. When the
+   * canvas is not rotated and y is a multiple of 8 this writes the
+   * bitmap buffer directly instead of going pixel by pixel.
+   */
+  void drawColumn(int16_t x, int16_t y, byte bits);
+
+  /*
+   * Set the 8x8 block with its top left corner at (x, y) from 8 row
+   * bytes: rows[0] is the top row and bit 7 its leftmost pixel. When
+   * the canvas is not rotated and x and y are multiples of 8 the block
+   * is written straight into the bitmap buffer of its display, which
+   * for displays rotated 90 degrees is a plain copy.
+   */
+  void drawRows(int16_t x, int16_t y, const byte *rows);
+
   /*
    * As we can do this much faster then setting all the pixels one by
    * one, we have a dedicated function to clear the screen.
@@ -99,12 +116,40 @@ public:
    */
   void write();
 
+  /*
+   * Re-send the control registers (display test, scan limit, decode
+   * mode, shutdown, intensity) and the bitmap every interval
+   * milliseconds, so a module that was reset or garbled by a supply
+   * glitch recovers on its own. 0 disables the refresh (the default).
+   */
+  void setRefreshInterval(unsigned long interval);
+
+  /*
+   * Call once per frame, after write(). When a refresh is due, each
+   * call sends one register or one bitmap row, so the refresh is spread
+   * over 13 calls instead of stalling a single frame.
+   */
+  void refreshStep();
+
 private:
   byte SPI_CS; /* SPI chip selection */
 
   /* Send out a single command to the device */
   void spiTransfer(byte opcode, byte data=0);
 
+  /*
+   * Send a control register, but only if its value changed. All
+   * displays share the same control values.
+   */
+  void setControl(byte opcode, byte data);
+
+  /* Last value sent for OP_DECODEMODE .. OP_SHUTDOWN */
+  byte controlShadow[4];
+
+  unsigned long refreshInterval;
+  unsigned long lastRefresh;
+  byte refreshIndex; /* Next refresh step, REFRESH_IDLE between refreshes */
+
   /* We keep track of the led-status for 8 devices in this array */
   byte *bitmap;
   byte bitmapSize;
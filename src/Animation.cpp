@@ -0,0 +1,294 @@
+#include "Animation.h"
+
+// Generated with tools/encode_animation.py.
+static const uint8_t ANIMATION_HEART[] PROGMEM = {
+    0x41, 0x4E, 0x0A, 0x04, 0x32, 0x01, 0x86, 0x08, 0x14, 0x24, 0x48, 0x24,
+    0x14, 0x08, 0x00, 0x32, 0x00, 0x88, 0x0C, 0x12, 0x22, 0x42, 0x84, 0x42,
+    0x22, 0x12, 0x0C,
+};
+
+static const uint8_t ANIMATION_WAVE[] PROGMEM = {
+    0x41, 0x4E, 0x20, 0x02, 0x08, 0x9E, 0x10, 0x00, 0x20, 0x00, 0x40, 0x00,
+    0x40, 0x00, 0x40, 0x00, 0x20, 0x00, 0x10, 0x00, 0x04, 0x00, 0x02, 0x00,
+    0x02, 0x00, 0x02, 0x00, 0x04, 0x00, 0x08, 0x00, 0x20, 0x00, 0x40, 0x00,
+    0x40, 0x00, 0x08, 0x07, 0x84, 0x20, 0x00, 0x10, 0x00, 0x08, 0x06, 0x84,
+    0x04, 0x00, 0x08, 0x00, 0x10, 0x06, 0x08, 0x82, 0x20, 0x00, 0x40, 0x08,
+    0x82, 0x04, 0x00, 0x02, 0x08, 0x82, 0x20, 0x00, 0x40, 0x04, 0x08, 0x05,
+    0x84, 0x20, 0x00, 0x10, 0x00, 0x08, 0x06, 0x84, 0x04, 0x00, 0x08, 0x00,
+    0x10, 0x06, 0x80, 0x20, 0x00, 0x08, 0x80, 0x40, 0x08, 0x82, 0x04, 0x00,
+    0x02, 0x08, 0x82, 0x20, 0x00, 0x40, 0x06, 0x08, 0x03, 0x84, 0x20, 0x00,
+    0x10, 0x00, 0x08, 0x06, 0x84, 0x04, 0x00, 0x08, 0x00, 0x10, 0x06, 0x82,
+    0x20, 0x00, 0x10, 0x00, 0x08, 0x07, 0x82, 0x04, 0x00, 0x02, 0x08, 0x82,
+    0x20, 0x00, 0x40, 0x08, 0x08, 0x01, 0x84, 0x20, 0x00, 0x10, 0x00, 0x08,
+    0x06, 0x84, 0x04, 0x00, 0x08, 0x00, 0x10, 0x06, 0x84, 0x20, 0x00, 0x10,
+    0x00, 0x08, 0x00, 0x08, 0x05, 0x82, 0x04, 0x00, 0x02, 0x08, 0x82, 0x20,
+    0x00, 0x40, 0x08, 0x80, 0x04, 0x00, 0x08, 0x84, 0x20, 0x00, 0x10, 0x00,
+    0x08, 0x06, 0x84, 0x04, 0x00, 0x08, 0x00, 0x10, 0x06, 0x84, 0x20, 0x00,
+    0x10, 0x00, 0x08, 0x02, 0x08, 0x03, 0x82, 0x04, 0x00, 0x02, 0x08, 0x82,
+    0x20, 0x00, 0x40, 0x08, 0x82, 0x04, 0x00, 0x02, 0x00, 0x08, 0x82, 0x10,
+    0x00, 0x08, 0x06, 0x84, 0x04, 0x00, 0x08, 0x00, 0x10, 0x06, 0x84, 0x20,
+    0x00, 0x10, 0x00, 0x08, 0x04, 0x08, 0x01, 0x82, 0x04, 0x00, 0x02, 0x08,
+    0x82, 0x20, 0x00, 0x40, 0x08, 0x82, 0x04, 0x00, 0x02, 0x02, 0x08, 0x80,
+    0x08, 0x06, 0x84, 0x04, 0x00, 0x08, 0x00, 0x10, 0x06, 0x84, 0x20, 0x00,
+    0x10, 0x00, 0x08, 0x06, 0x08, 0x82, 0x04, 0x00, 0x02, 0x08, 0x82, 0x20,
+    0x00, 0x40, 0x08, 0x82, 0x04, 0x00, 0x02, 0x04, 0x08, 0x05, 0x84, 0x04,
+    0x00, 0x08, 0x00, 0x10, 0x06, 0x84, 0x20, 0x00, 0x10, 0x00, 0x08, 0x06,
+    0x80, 0x04, 0x00, 0x08, 0x80, 0x02, 0x08, 0x82, 0x20, 0x00, 0x40, 0x08,
+    0x82, 0x04, 0x00, 0x02, 0x06, 0x08, 0x03, 0x84, 0x04, 0x00, 0x08, 0x00,
+    0x10, 0x06, 0x84, 0x20, 0x00, 0x10, 0x00, 0x08, 0x06, 0x82, 0x04, 0x00,
+    0x08, 0x00, 0x08, 0x07, 0x82, 0x20, 0x00, 0x40, 0x08, 0x82, 0x04, 0x00,
+    0x02, 0x08, 0x08, 0x01, 0x84, 0x04, 0x00, 0x08, 0x00, 0x10, 0x06, 0x84,
+    0x20, 0x00, 0x10, 0x00, 0x08, 0x06, 0x84, 0x04, 0x00, 0x08, 0x00, 0x10,
+    0x00, 0x08, 0x05, 0x82, 0x20, 0x00, 0x40, 0x08, 0x82, 0x04, 0x00, 0x02,
+    0x08, 0x80, 0x20, 0x00, 0x08, 0x84, 0x04, 0x00, 0x08, 0x00, 0x10, 0x06,
+    0x84, 0x20, 0x00, 0x10, 0x00, 0x08, 0x06, 0x84, 0x04, 0x00, 0x08, 0x00,
+    0x10, 0x02, 0x08, 0x03, 0x82, 0x20, 0x00, 0x40, 0x08, 0x82, 0x04, 0x00,
+    0x02, 0x08, 0x82, 0x20, 0x00, 0x40, 0x00, 0x08, 0x82, 0x08, 0x00, 0x10,
+    0x06, 0x84, 0x20, 0x00, 0x10, 0x00, 0x08, 0x06, 0x84, 0x04, 0x00, 0x08,
+    0x00, 0x10, 0x04,
+};
+
+static const uint8_t ANIMATION_PULSE[] PROGMEM = {
+    0x41, 0x4E, 0x12, 0x01, 0x14, 0x07, 0x42, 0x10, 0x06, 0x14, 0x06, 0x84,
+    0x10, 0x38, 0x28, 0x38, 0x10, 0x05, 0x14, 0x05, 0x86, 0x10, 0x38, 0x28,
+    0x00, 0x28, 0x38, 0x10, 0x04, 0x14, 0x04, 0x88, 0x10, 0x38, 0x6C, 0x44,
+    0x00, 0x44, 0x6C, 0x38, 0x10, 0x03, 0x14, 0x03, 0x8A, 0x10, 0x38, 0x6C,
+    0x44, 0x00, 0x00, 0x00, 0x44, 0x6C, 0x38, 0x10, 0x02, 0x14, 0x02, 0x84,
+    0x10, 0x38, 0x6C, 0xC6, 0x82, 0x02, 0x84, 0x82, 0xC6, 0x6C, 0x38, 0x10,
+    0x01, 0x14, 0x01, 0x85, 0x10, 0x38, 0x6C, 0xC6, 0x82, 0x00, 0x02, 0x85,
+    0x00, 0x82, 0xC6, 0x6C, 0x38, 0x10, 0x00, 0x14, 0x00, 0x85, 0x10, 0x38,
+    0x6C, 0xC6, 0x83, 0x01, 0x04, 0x85, 0x01, 0x83, 0xC6, 0x6C, 0x38, 0x10,
+    0x14, 0x00, 0x50, 0x00, 0x14, 0x11, 0x14, 0x11, 0x14, 0x11, 0x14, 0x11,
+    0x14, 0x07, 0x82, 0x10, 0x38, 0x10, 0x06, 0x14, 0x11, 0x14, 0x07, 0x82,
+    0x00, 0x10, 0x00, 0x06,
+};
+
+struct BuiltinAnimation
+{
+  const char *name;
+  const uint8_t *data;
+  size_t length;
+};
+
+static const BuiltinAnimation BUILTIN_ANIMATIONS[] = {
+    {"heart", ANIMATION_HEART, sizeof(ANIMATION_HEART)},
+    {"wave", ANIMATION_WAVE, sizeof(ANIMATION_WAVE)},
+    {"pulse", ANIMATION_PULSE, sizeof(ANIMATION_PULSE)},
+};
+
+static const size_t ANIMATION_HEADER_SIZE = 4;
+
+FileAnimationSource::FileAnimationSource(const String &path) : bufferLength(0), bufferOffset(0)
+{
+  file = LittleFS.open(path, "r");
+}
+
+FileAnimationSource::~FileAnimationSource()
+{
+  if (file)
+  {
+    file.close();
+  }
+}
+
+int FileAnimationSource::read()
+{
+  if (bufferOffset >= bufferLength)
+  {
+    bufferOffset = 0;
+    bufferLength = file ? file.read(buffer, BUFFER_SIZE) : 0;
+    if (bufferLength == 0)
+    {
+      return -1;
+    }
+  }
+  return buffer[bufferOffset++];
+}
+
+bool FileAnimationSource::seek(size_t offset)
+{
+  bufferLength = 0;
+  bufferOffset = 0;
+  return file && file.seek(offset);
+}
+
+AnimationPlayer::AnimationPlayer(AnimationSource &sourceRef)
+    : source(sourceRef), frameWidth(0), loopCount(0), loop(0), frameSeen(false), corrupt(false)
+{
+}
+
+bool AnimationPlayer::begin()
+{
+  loop = 0;
+  frameSeen = false;
+  corrupt = false;
+  if (!source.seek(0) || source.read() != 'A' || source.read() != 'N')
+  {
+    return false;
+  }
+  int width = source.read();
+  int loops = source.read();
+  if (width <= 0 || loops < 0)
+  {
+    return false;
+  }
+  frameWidth = width;
+  loopCount = loops > 0 ? loops : 1;
+  return true;
+}
+
+bool AnimationPlayer::validate()
+{
+  if (!begin())
+  {
+    return false;
+  }
+
+  // One pass is enough: every loop replays the same frames.
+  FrameLayer scratch(frameWidth, 8);
+  loopCount = 1;
+  unsigned int frames = 0;
+  while (nextFrame(scratch, 0) > 0)
+  {
+    frames++;
+  }
+  bool valid = frames > 0 && !corrupt;
+  return begin() && valid;
+}
+
+unsigned long AnimationPlayer::nextFrame(FrameLayer &layer, int16_t x0)
+{
+  while (true)
+  {
+    int ticks = source.read();
+    if (ticks > 0)
+    {
+      if (!decodeColumns(layer, x0))
+      {
+        corrupt = true;
+        return 0;
+      }
+      frameSeen = true;
+      return (unsigned long)ticks * ANIMATION_TICK_MS;
+    }
+
+    // End of the data: start the next loop from a blank frame.
+    if (!frameSeen || ++loop >= loopCount || !source.seek(ANIMATION_HEADER_SIZE))
+    {
+      return 0;
+    }
+    layer.clearColumns(x0, x0 + frameWidth);
+    frameSeen = false;
+  }
+}
+
+bool AnimationPlayer::decodeColumns(FrameLayer &layer, int16_t x0)
+{
+  int column = 0;
+  while (column < frameWidth)
+  {
+    int op = source.read();
+    if (op < 0)
+    {
+      return false;
+    }
+    int count = (op & ((op & 0x80) ? 0x7F : 0x3F)) + 1;
+    if (column + count > frameWidth)
+    {
+      return false;
+    }
+
+    if (op & 0x80)
+    {
+      for (int i = 0; i < count; i++)
+      {
+        int bits = source.read();
+        if (bits < 0)
+        {
+          return false;
+        }
+        layer.drawColumn(x0 + column + i, 0, bits);
+      }
+    }
+    else if (op & 0x40)
+    {
+      int bits = source.read();
+      if (bits < 0)
+      {
+        return false;
+      }
+      for (int i = 0; i < count; i++)
+      {
+        layer.drawColumn(x0 + column + i, 0, bits);
+      }
+    }
+    column += count;
+  }
+  return true;
+}
+
+const uint8_t *AnimationPlayer::builtin(const String &name, size_t &length)
+{
+  for (const BuiltinAnimation &animation : BUILTIN_ANIMATIONS)
+  {
+    if (name == animation.name)
+    {
+      length = animation.length;
+      return animation.data;
+    }
+  }
+  return nullptr;
+}
+
+bool AnimationPlayer::isValidName(const String &name)
+{
+  if (name.length() == 0 || name.length() > ANIMATION_MAX_NAME_LENGTH)
+  {
+    return false;
+  }
+  for (unsigned int i = 0; i < name.length(); i++)
+  {
+    char c = name[i];
+    if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-'))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+String AnimationPlayer::pathFor(const String &name)
+{
+  return String(ANIMATION_DIRECTORY) + "/" + name + ".anim";
+}
+
+String AnimationPlayer::namesJson(size_t maxLength)
+{
+  String json = "[";
+  for (const BuiltinAnimation &animation : BUILTIN_ANIMATIONS)
+  {
+    if (json.length() > 1)
+    {
+      json += ",";
+    }
+    json += "\"" + String(animation.name) + "\"";
+  }
+
+  Dir dir = LittleFS.openDir(ANIMATION_DIRECTORY);
+  while (dir.next())
+  {
+    String name = dir.fileName();
+    if (!name.endsWith(".anim"))
+    {
+      continue;
+    }
+    name.remove(name.length() - 5);
+    size_t length;
+    // Comma, quotes and the closing bracket.
+    if (isValidName(name) && builtin(name, length) == nullptr && json.length() + name.length() + 4 <= maxLength)
+    {
+      json += ",\"" + name + "\"";
+    }
+  }
+  return json + "]";
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "Arduino.h"
+#include <LittleFS.h>
+#include "FrameLayer.h"
+
+// Animation limits
+const unsigned int ANIMATION_TICK_MS = 10;         // Unit of the per-frame duration byte
+const size_t ANIMATION_MAX_FILE_SIZE = 16384;      // Largest accepted upload
+const uint8_t ANIMATION_MAX_NAME_LENGTH = 24;      // [a-z0-9_-] only
+const char *const ANIMATION_DIRECTORY = "/anim";   // Uploaded animations: /anim/<name>.anim
+
+// Binary animation format (".anim"), 8 rows high:
+//
+//   header  'A' 'N' width loops        width 1-255 columns, played loops times
+//   frame   duration op op ...         duration in ANIMATION_TICK_MS units
+//
+// A frame's ops cover exactly `width` columns, left to right, as changes to
+// the previous frame (the first one starts from blank). A column is one byte,
+// bit 0 = top row, like the clock digits:
+//
+//   0x00-0x3F  keep the next n+1 columns as they are
+//   0x40-0x7F  set the next n+1 columns to the byte that follows
+//   0x80-0xFF  n+1 column bytes follow
+//
+// The animation ends at a zero duration byte or at the end of the data.
+// tools/encode_animation.py turns text art into this format.
+class AnimationSource
+{
+public:
+  virtual ~AnimationSource() {}
+  virtual int read() = 0;              // Next byte, or -1 at the end
+  virtual bool seek(size_t offset) = 0;
+};
+
+class ProgmemAnimationSource : public AnimationSource
+{
+public:
+  ProgmemAnimationSource(const uint8_t *dataRef, size_t lengthRef) : data(dataRef), length(lengthRef), offset(0) {}
+  int read() override { return offset < length ? pgm_read_byte(data + offset++) : -1; }
+  bool seek(size_t to) override
+  {
+    offset = to;
+    return to <= length;
+  }
+
+private:
+  const uint8_t *data;
+  size_t length;
+  size_t offset;
+};
+
+// Reads a LittleFS file through a small buffer, so playing a long animation
+// costs a few dozen bytes of RAM.
+class FileAnimationSource : public AnimationSource
+{
+public:
+  explicit FileAnimationSource(const String &path);
+  ~FileAnimationSource();
+
+  bool isOpen() const { return (bool)file; }
+  int read() override;
+  bool seek(size_t offset) override;
+
+private:
+  static const uint8_t BUFFER_SIZE = 32;
+
+  File file;
+  uint8_t buffer[BUFFER_SIZE];
+  uint8_t bufferLength;
+  uint8_t bufferOffset;
+};
+
+// Decodes one frame at a time straight into a layer; the layer itself holds
+// the previous frame the deltas apply to.
+class AnimationPlayer
+{
+public:
+  explicit AnimationPlayer(AnimationSource &sourceRef);
+
+  bool begin(); // Reads the header; false if it is not an animation
+  // Decode every frame once; false unless the data is an animation with at
+  // least one frame whose ops all fit. Leaves the player ready to play.
+  bool validate();
+  uint8_t width() const { return frameWidth; }
+  uint8_t loops() const { return loopCount; }
+
+  // Decode the next frame into columns [x0, x0 + width()) of the layer and
+  // return how long to show it (ms), or 0 past the last frame of the last
+  // loop or on corrupt data; isCorrupt() tells the two apart. Columns
+  // outside the layer are clipped.
+  unsigned long nextFrame(FrameLayer &layer, int16_t x0);
+  // A frame's ops ran past its width or the data ended inside a frame.
+  bool isCorrupt() const { return corrupt; }
+
+  // Built-in animation by name, or nullptr.
+  static const uint8_t *builtin(const String &name, size_t &length);
+  static bool isValidName(const String &name);
+  static String pathFor(const String &name);
+  // JSON array of the built-in names followed by the uploaded ones, leaving
+  // out the uploaded names that would take it past maxLength characters.
+  static String namesJson(size_t maxLength = SIZE_MAX);
+
+private:
+  AnimationSource &source;
+  uint8_t frameWidth;
+  uint8_t loopCount;
+  uint8_t loop;
+  bool frameSeen; // At least one frame decoded in the current loop
+  bool corrupt;
+
+  bool decodeColumns(FrameLayer &layer, int16_t x0);
+};
@@ -15,3 +15,8 @@
 // the very first boot-time scroll.
 void serviceBackground();
 void serviceDelay(unsigned long ms);
+
+// Called right before the firmware deliberately goes away (OTA start and end,
+// reboot) so state that is only flushed lazily, such as debounced settings
+// and the time kept in RTC memory, is up to date first.
+void prepareForRestart();
@@ -0,0 +1,46 @@
+#include "BootTimeline.h"
+
+unsigned long BootTimeline::phases[BOOT_PHASE_COUNT] = {};
+
+static const char *const BOOT_PHASE_NAMES[BOOT_PHASE_COUNT] = {
+    "setup", "display", "intro", "settings", "first_frame", "wifi", "services", "time_synced", "mqtt_connected"};
+
+void BootTimeline::mark(BootPhase phase)
+{
+  if (phases[phase] != 0)
+  {
+    return;
+  }
+  // setup() can start within the first millisecond; keep 0 meaning "not yet".
+  unsigned long now = millis();
+  phases[phase] = now ? now : 1;
+  Serial.println("Boot: " + String(BOOT_PHASE_NAMES[phase]) + " at " + String(phases[phase]) + " ms");
+}
+
+bool BootTimeline::isWarmBoot()
+{
+  return ESP.getResetInfoPtr()->reason != REASON_DEFAULT_RST;
+}
+
+String BootTimeline::toJson()
+{
+  String json = "{\"warm\":" + String(isWarmBoot() ? "true" : "false") + ",";
+  json += "\"reset_reason\":\"" + ESP.getResetReason() + "\",";
+  json += "\"phases_ms\":{";
+  bool first = true;
+  for (int i = 0; i < BOOT_PHASE_COUNT; i++)
+  {
+    if (phases[i] == 0)
+    {
+      continue;
+    }
+    if (!first)
+    {
+      json += ",";
+    }
+    first = false;
+    json += "\"" + String(BOOT_PHASE_NAMES[i]) + "\":" + String(phases[i]);
+  }
+  json += "}}";
+  return json;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "Arduino.h"
+
+// Boot milestones, in the order they normally happen. With Wi-Fi coming up
+// in the background the later ones may arrive in a different order.
+enum BootPhase : uint8_t
+{
+  BOOT_SETUP,           // setup() entered (SDK and core start-up before this)
+  BOOT_DISPLAY,         // Matrix configured, first text on the panel
+  BOOT_INTRO,           // Intro animation finished (or skipped)
+  BOOT_SETTINGS,        // Settings loaded, filesystem mounted
+  BOOT_FIRST_FRAME,     // First clock frame drawn by the render task
+  BOOT_WIFI,            // Associated with the access point
+  BOOT_SERVICES,        // OTA and web updater listening
+  BOOT_TIME_SYNCED,     // First successful time server sync
+  BOOT_MQTT_CONNECTED,  // First broker connection
+  BOOT_PHASE_COUNT
+};
+
+// Records millis() at each boot phase, so slow boots can be traced to a
+// phase. Published once (retained) on the boot topic after the first MQTT
+// connect.
+class BootTimeline
+{
+public:
+  static void mark(BootPhase phase); // Only the first mark of a phase counts
+  static bool isWarmBoot();          // Reset without a power cut: RTC memory is intact
+
+  // {"warm":..,"reset_reason":..,"phases_ms":{"setup":..,"display":..,...}};
+  // phases not reached yet are left out.
+  static String toJson();
+
+private:
+  static unsigned long phases[BOOT_PHASE_COUNT]; // 0 = not reached
+};
@@ -0,0 +1,172 @@
+#include "BrightnessAnimator.h"
+
+// Perceived brightness of each intensity level: 1024 * (duty / max duty)^(1/2.2),
+// where the MAX7219 duty cycle for level L is (2L + 1) / 32.
+static const uint16_t LEVEL_PERCEIVED[16] PROGMEM = {215, 354, 447, 521, 584, 639, 690, 736,
+                                                     779, 820, 858, 894, 929, 962, 993, 1024};
+
+BrightnessAnimator::BrightnessAnimator(Max72xxPanel &matrixRef)
+    : matrix(matrixRef), head(0), count(0), segmentStart(0), startPerceived(0), perceived(0), level(-1)
+{
+}
+
+uint16_t BrightnessAnimator::toPerceived(int level)
+{
+  return pgm_read_word(&LEVEL_PERCEIVED[constrain(level, 0, 15)]);
+}
+
+int BrightnessAnimator::toLevel(uint16_t value)
+{
+  // Nearest level; the table is increasing.
+  for (int i = 0; i < 15; i++)
+  {
+    uint16_t midpoint = (pgm_read_word(&LEVEL_PERCEIVED[i]) + pgm_read_word(&LEVEL_PERCEIVED[i + 1])) / 2;
+    if (value < midpoint)
+    {
+      return i;
+    }
+  }
+  return 15;
+}
+
+uint16_t BrightnessAnimator::ease(BrightnessEasing easing, uint16_t t)
+{
+  uint32_t t2 = ((uint32_t)t * t) >> 10;
+  switch (easing)
+  {
+  case EASE_IN:
+    return t2;
+  case EASE_OUT:
+  {
+    uint32_t u = 1024 - t;
+    return 1024 - ((u * u) >> 10);
+  }
+  case EASE_IN_OUT:
+    return (3 * t2) - ((2 * t2 * t) >> 10);
+  case EASE_LINEAR:
+  default:
+    return t;
+  }
+}
+
+void BrightnessAnimator::apply(uint16_t value)
+{
+  perceived = value;
+  int newLevel = toLevel(value);
+  if (newLevel != level)
+  {
+    level = newLevel;
+    matrix.setIntensity(level);
+  }
+}
+
+void BrightnessAnimator::set(int newLevel)
+{
+  count = 0;
+  newLevel = constrain(newLevel, 0, 15);
+  perceived = toPerceived(newLevel);
+  if (newLevel != level)
+  {
+    level = newLevel;
+    matrix.setIntensity(level);
+  }
+}
+
+void BrightnessAnimator::fadeTo(int newLevel, unsigned long durationMs, BrightnessEasing easing)
+{
+  tick(); // Start from wherever a running transition has got to
+  count = 0;
+  queue(newLevel, durationMs, easing);
+}
+
+bool BrightnessAnimator::queue(int newLevel, unsigned long durationMs, BrightnessEasing easing)
+{
+  if (count >= BRIGHTNESS_MAX_KEYFRAMES)
+  {
+    return false;
+  }
+  if (count == 0)
+  {
+    head = 0;
+    segmentStart = millis();
+    startPerceived = perceived;
+  }
+
+  Keyframe &keyframe = keyframes[(head + count) % BRIGHTNESS_MAX_KEYFRAMES];
+  keyframe.level = constrain(newLevel, 0, 15);
+  keyframe.easing = easing;
+  keyframe.durationMs = durationMs;
+  count++;
+  return true;
+}
+
+void BrightnessAnimator::hold(unsigned long durationMs)
+{
+  queue(getFinalLevel(), durationMs, EASE_LINEAR);
+}
+
+int BrightnessAnimator::getFinalLevel() const
+{
+  if (count == 0)
+  {
+    return level;
+  }
+  return keyframes[(head + count - 1) % BRIGHTNESS_MAX_KEYFRAMES].level;
+}
+
+void BrightnessAnimator::retarget(int newLevel, unsigned long durationMs)
+{
+  newLevel = constrain(newLevel, 0, 15);
+  if (newLevel == getFinalLevel())
+  {
+    return;
+  }
+  if (count > 0)
+  {
+    keyframes[(head + count - 1) % BRIGHTNESS_MAX_KEYFRAMES].level = newLevel;
+    return;
+  }
+  fadeTo(newLevel, durationMs);
+}
+
+unsigned long BrightnessAnimator::remainingMs() const
+{
+  if (count == 0)
+  {
+    return 0;
+  }
+  unsigned long total = 0;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    total += keyframes[(head + i) % BRIGHTNESS_MAX_KEYFRAMES].durationMs;
+  }
+  unsigned long elapsed = millis() - segmentStart;
+  return elapsed >= total ? 0 : total - elapsed;
+}
+
+void BrightnessAnimator::tick()
+{
+  unsigned long now = millis();
+  while (count > 0)
+  {
+    const Keyframe &keyframe = keyframes[head];
+    uint16_t target = toPerceived(keyframe.level);
+    unsigned long elapsed = now - segmentStart;
+
+    if (elapsed < keyframe.durationMs)
+    {
+      uint16_t t = (uint16_t)((elapsed << 10) / keyframe.durationMs);
+      int32_t delta = (int32_t)target - startPerceived;
+      apply(startPerceived + (int16_t)((delta * ease(keyframe.easing, t)) >> 10));
+      return;
+    }
+
+    // Keyframe done: land exactly on it and chain the next one from its end
+    // time, so a late tick doesn't stretch the sequence.
+    apply(target);
+    segmentStart += keyframe.durationMs;
+    startPerceived = target;
+    head = (head + 1) % BRIGHTNESS_MAX_KEYFRAMES;
+    count--;
+  }
+}
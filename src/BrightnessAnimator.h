@@ -0,0 +1,70 @@
+#pragma once
+#include "Arduino.h"
+#include <Adafruit_GFX.h>
+#include <Max72xxPanel.h>
+
+const unsigned long BRIGHTNESS_TICK_MS = 20;        // Tick period while a transition is running
+const unsigned long BRIGHTNESS_CROSSFADE_MS = 3000; // Day/night and settings changes
+const uint8_t BRIGHTNESS_MAX_KEYFRAMES = 8;
+
+enum BrightnessEasing : uint8_t
+{
+  EASE_LINEAR,
+  EASE_IN,     // Slow start
+  EASE_OUT,    // Slow finish
+  EASE_IN_OUT  // Smoothstep
+};
+
+// Non-blocking panel intensity transitions. Keyframes (target level,
+// duration, easing) are queued and played back by tick(), which is called
+// from the main loop and serviceBackground(). Nothing here ever waits.
+//
+// The MAX7219 has 16 intensity levels with linear duty steps, and the eye
+// sees far more difference between the low levels than the high ones.
+// Transitions are therefore interpolated in perceptual units
+// (gamma-corrected duty, 0-1024) and mapped back to the nearest level, so a
+// fade spends longer on the low levels and looks even. The chip is only
+// written when the level actually changes.
+class BrightnessAnimator
+{
+public:
+  explicit BrightnessAnimator(Max72xxPanel &matrixRef);
+
+  void set(int level);                                                      // Jump now, drop queued keyframes
+  void fadeTo(int level, unsigned long durationMs, BrightnessEasing easing = EASE_IN_OUT); // Replace queue
+  bool queue(int level, unsigned long durationMs, BrightnessEasing easing = EASE_IN_OUT);  // Append; false if full
+  void hold(unsigned long durationMs);                                      // Stay at the final level a while
+
+  // Make `level` where things end up: changes the final keyframe of a running
+  // sequence (boot intro, flash) or starts a fade if idle. No-op if it is
+  // already the final level.
+  void retarget(int level, unsigned long durationMs);
+
+  void tick();
+  bool isAnimating() const { return count > 0; }
+  unsigned long remainingMs() const; // Until the last keyframe completes
+  int getLevel() const { return level; }
+  int getFinalLevel() const;
+
+private:
+  struct Keyframe
+  {
+    uint8_t level;
+    BrightnessEasing easing;
+    unsigned long durationMs;
+  };
+
+  Max72xxPanel &matrix;
+  Keyframe keyframes[BRIGHTNESS_MAX_KEYFRAMES];
+  uint8_t head;
+  uint8_t count;
+  unsigned long segmentStart; // millis() when the head keyframe started
+  uint16_t startPerceived;    // Perceived brightness at segmentStart
+  uint16_t perceived;         // Current perceived brightness
+  int level;                  // Level last written to the chip
+
+  void apply(uint16_t value);
+  static uint16_t ease(BrightnessEasing easing, uint16_t t); // t and result in 0-1024
+  static uint16_t toPerceived(int level);
+  static int toLevel(uint16_t perceived);
+};
@@ -0,0 +1,150 @@
+#include "ClockFace.h"
+
+// Column bitmaps, bit 0 = top row. Index 10 is '-'.
+static const uint8_t SMALL_DIGITS[CLOCK_DIGIT_GLYPHS][5] PROGMEM = {
+    {0x3E, 0x41, 0x41, 0x41, 0x3E}, // 0
+    {0x00, 0x42, 0x7F, 0x40, 0x00}, // 1
+    {0x42, 0x61, 0x51, 0x49, 0x46}, // 2
+    {0x22, 0x41, 0x49, 0x49, 0x36}, // 3
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, // 4
+    {0x27, 0x45, 0x45, 0x45, 0x39}, // 5
+    {0x3C, 0x4A, 0x49, 0x49, 0x30}, // 6
+    {0x01, 0x71, 0x09, 0x05, 0x03}, // 7
+    {0x36, 0x49, 0x49, 0x49, 0x36}, // 8
+    {0x06, 0x49, 0x49, 0x29, 0x1E}, // 9
+    {0x08, 0x08, 0x08, 0x08, 0x08}, // -
+};
+
+static const uint8_t LARGE_DIGITS[CLOCK_DIGIT_GLYPHS][5] PROGMEM = {
+    {0x7E, 0x81, 0x81, 0x81, 0x7E}, // 0
+    {0x84, 0x82, 0xFF, 0x80, 0x80}, // 1
+    {0xC2, 0xA1, 0x91, 0x89, 0x86}, // 2
+    {0x42, 0x81, 0x89, 0x89, 0x76}, // 3
+    {0x18, 0x14, 0x12, 0xFF, 0x10}, // 4
+    {0x4F, 0x89, 0x89, 0x89, 0x71}, // 5
+    {0x7C, 0x8A, 0x89, 0x89, 0x70}, // 6
+    {0x01, 0xC1, 0x31, 0x0D, 0x03}, // 7
+    {0x76, 0x89, 0x89, 0x89, 0x76}, // 8
+    {0x0E, 0x91, 0x91, 0x51, 0x3E}, // 9
+    {0x08, 0x08, 0x08, 0x08, 0x08}, // -
+};
+
+// 3x5 on rows 1-5.
+static const uint8_t TINY_DIGITS[CLOCK_DIGIT_GLYPHS][3] PROGMEM = {
+    {0x3E, 0x22, 0x3E}, // 0
+    {0x24, 0x3E, 0x20}, // 1
+    {0x3A, 0x2A, 0x2E}, // 2
+    {0x2A, 0x2A, 0x3E}, // 3
+    {0x0E, 0x08, 0x3E}, // 4
+    {0x2E, 0x2A, 0x3A}, // 5
+    {0x3E, 0x2A, 0x3A}, // 6
+    {0x02, 0x02, 0x3E}, // 7
+    {0x3E, 0x2A, 0x3E}, // 8
+    {0x2E, 0x2A, 0x3E}, // 9
+    {0x08, 0x08, 0x08}, // -
+};
+
+ClockFace::ClockFace()
+{
+  setStyle(CLOCK_DIGITS_SMALL, false);
+}
+
+void ClockFace::setStyle(ClockDigitStyle style, bool bar)
+{
+  secondsBar = bar;
+  if (style == CLOCK_DIGITS_TINY)
+  {
+    digitWidth = 3;
+    colonColumn = 0x14; // Rows 2 and 4
+    for (uint8_t g = 0; g < CLOCK_DIGIT_GLYPHS; g++)
+    {
+      memcpy_P(digits[g], TINY_DIGITS[g], 3);
+    }
+    return;
+  }
+
+  bool tall = (style != CLOCK_DIGITS_SMALL) && !bar;
+  const uint8_t(*source)[5] = tall ? LARGE_DIGITS : SMALL_DIGITS;
+  colonColumn = tall ? 0x24 : 0x14; // Dots on rows 2 and 5, or 2 and 4
+
+  if (style == CLOCK_DIGITS_BOLD)
+  {
+    // Smear every column one to the right: vertical strokes become 2 wide.
+    digitWidth = 6;
+    for (uint8_t g = 0; g < CLOCK_DIGIT_GLYPHS; g++)
+    {
+      uint8_t previous = 0;
+      for (uint8_t col = 0; col < 5; col++)
+      {
+        uint8_t bits = pgm_read_byte(&source[g][col]);
+        digits[g][col] = bits | previous;
+        previous = bits;
+      }
+      digits[g][5] = previous;
+    }
+    return;
+  }
+
+  digitWidth = 5;
+  for (uint8_t g = 0; g < CLOCK_DIGIT_GLYPHS; g++)
+  {
+    memcpy_P(digits[g], source[g], 5);
+  }
+}
+
+int ClockFace::drawDigit(FrameLayer &layer, int x, uint8_t glyph)
+{
+  for (uint8_t col = 0; col < digitWidth; col++)
+  {
+    layer.drawColumn(x + col, 0, digits[glyph][col]);
+  }
+  return digitWidth + 1;
+}
+
+void ClockFace::render(FrameLayer &layer, int x0, int width, int hour, int minute, int second, bool colon)
+{
+  uint8_t glyphs[4];
+  uint8_t count = 0;
+  if (hour < 0)
+  {
+    glyphs[count++] = 10;
+    glyphs[count++] = 10;
+    glyphs[count++] = 10;
+    glyphs[count++] = 10;
+  }
+  else
+  {
+    if (hour >= 10)
+    {
+      glyphs[count++] = hour / 10;
+    }
+    glyphs[count++] = hour % 10;
+    glyphs[count++] = minute / 10;
+    glyphs[count++] = minute % 10;
+  }
+
+  // Digits and the colon, each followed by one blank column (the last one
+  // excluded from the width).
+  int timeWidth = count * (digitWidth + 1) + 2 - 1;
+  int x = x0 + (width - timeWidth) / 2;
+
+  layer.clearColumns(x0, x0 + width);
+  for (uint8_t i = 0; i < count; i++)
+  {
+    if (i == count - 2)
+    {
+      layer.drawColumn(x, 0, colon ? colonColumn : 0);
+      x += 2;
+    }
+    x += drawDigit(layer, x, glyphs[i]);
+  }
+
+  if (secondsBar && hour >= 0)
+  {
+    int length = (second + 1) * width / 60;
+    for (int col = 0; col < length; col++)
+    {
+      layer.drawPixel(x0 + col, layer.height() - 1, HIGH);
+    }
+  }
+}
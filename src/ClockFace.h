@@ -0,0 +1,45 @@
+#pragma once
+#include "Arduino.h"
+#include "FrameLayer.h"
+
+enum ClockDigitStyle : uint8_t
+{
+  CLOCK_DIGITS_SMALL, // 5x7, same as the text font; the bottom row stays free
+  CLOCK_DIGITS_LARGE, // 5x8, full panel height
+  CLOCK_DIGITS_BOLD,  // 6x8, LARGE with double-width strokes
+  CLOCK_DIGITS_TINY   // 3x5, for a clock sharing the panel with other content
+};
+
+const uint8_t CLOCK_DIGIT_GLYPHS = 11; // 0-9 and '-' (time not known yet)
+const uint8_t CLOCK_MAX_DIGIT_WIDTH = 6;
+
+// Dedicated renderer for the HH:MM clock face. Digit columns for the chosen
+// style are worked out once in setStyle(), so drawing a frame is one column
+// write per digit column: no glyph lookup, text measuring or per-pixel
+// drawChar(). Digits are tabular (fixed width), so the time doesn't shift
+// as it changes, and hours are not zero-padded.
+//
+// The optional seconds bar fills the bottom row from left to right over each
+// minute. Full-height styles then use 7-row digits (LARGE becomes SMALL,
+// BOLD a double-stroke SMALL) to leave the row free.
+class ClockFace
+{
+public:
+  ClockFace();
+
+  void setStyle(ClockDigitStyle style, bool secondsBar);
+  // Width of the widest time ("--:--" or a two-digit hour).
+  int maxWidth() const { return 4 * (digitWidth + 1) + 2 - 1; }
+
+  // Clear columns [x0, x0 + width) of the layer and draw the time centred
+  // in them (hour < 0 draws "--:--").
+  void render(FrameLayer &layer, int x0, int width, int hour, int minute, int second, bool colon);
+
+private:
+  uint8_t digits[CLOCK_DIGIT_GLYPHS][CLOCK_MAX_DIGIT_WIDTH];
+  uint8_t digitWidth;
+  uint8_t colonColumn;
+  bool secondsBar;
+
+  int drawDigit(FrameLayer &layer, int x, uint8_t glyph); // Returns the advance
+};
@@ -0,0 +1,131 @@
+#include "Compositor.h"
+
+Compositor::Compositor(Max72xxPanel &matrixRef)
+    : matrix(matrixRef), layerCount(0), words((matrixRef.width() + 31) / 32)
+{
+  band = new uint32_t[8 * words];
+}
+
+Compositor::~Compositor()
+{
+  delete[] band;
+}
+
+int8_t Compositor::addLayer(FrameLayer &layer, LayerBlend blend)
+{
+  if (layerCount >= COMPOSITOR_MAX_LAYERS)
+  {
+    return -1;
+  }
+  layers[layerCount] = {&layer, blend, 0, layer.width(), true};
+  return layerCount++;
+}
+
+void Compositor::setVisible(uint8_t index, bool visible)
+{
+  if (index < layerCount)
+  {
+    layers[index].visible = visible;
+  }
+}
+
+void Compositor::setWindow(uint8_t index, int16_t x0, int16_t x1)
+{
+  if (index < layerCount)
+  {
+    layers[index].x0 = max(x0, (int16_t)0);
+    layers[index].x1 = min(x1, layers[index].layer->width());
+  }
+}
+
+void Compositor::setBlend(uint8_t index, LayerBlend blend)
+{
+  if (index < layerCount)
+  {
+    layers[index].blend = blend;
+  }
+}
+
+void Compositor::windowsFor(uint8_t word, uint32_t *windows) const
+{
+  for (uint8_t i = 0; i < layerCount; i++)
+  {
+    windows[i] = layers[i].visible ? columnMask(layers[i].x0, layers[i].x1, word) : 0;
+  }
+}
+
+uint32_t Compositor::composeWord(int16_t y, uint8_t word, const uint32_t *windows) const
+{
+  uint32_t bits = 0;
+  for (uint8_t i = 0; i < layerCount; i++)
+  {
+    if (!windows[i] || y >= layers[i].layer->height())
+    {
+      continue;
+    }
+
+    uint32_t layerBits = layers[i].layer->row(y)[word] & windows[i];
+    switch (layers[i].blend)
+    {
+    case BLEND_OR:
+      bits |= layerBits;
+      break;
+    case BLEND_XOR:
+      bits ^= layerBits;
+      break;
+    case BLEND_MASK:
+      bits &= ~layerBits;
+      break;
+    case BLEND_REPLACE:
+      bits = (bits & ~windows[i]) | layerBits;
+      break;
+    }
+  }
+  return bits;
+}
+
+void Compositor::present()
+{
+  int16_t width = matrix.width();
+  int16_t height = matrix.height();
+
+  for (int16_t top = 0; top < height; top += 8)
+  {
+    // Compose the band's 8 rows a word at a time.
+    for (uint8_t w = 0; w < words; w++)
+    {
+      uint32_t windows[COMPOSITOR_MAX_LAYERS];
+      windowsFor(w, windows);
+      for (uint8_t row = 0; row < 8; row++)
+      {
+        band[row * words + w] = composeWord(top + row, w, windows);
+      }
+    }
+
+    // Hand each module its 8 row bytes.
+    for (int16_t x = 0; x < width; x += 8)
+    {
+      uint8_t shift = 24 - (x & 31);
+      byte block[8];
+      for (uint8_t row = 0; row < 8; row++)
+      {
+        block[row] = band[row * words + (x >> 5)] >> shift;
+      }
+      matrix.drawRows(x, top, block);
+    }
+  }
+  matrix.write();
+}
+
+void Compositor::composeInto(FrameLayer &target)
+{
+  for (uint8_t w = 0; w < words && w < target.words(); w++)
+  {
+    uint32_t windows[COMPOSITOR_MAX_LAYERS];
+    windowsFor(w, windows);
+    for (int16_t y = 0; y < target.height(); y++)
+    {
+      target.row(y)[w] = composeWord(y, w, windows);
+    }
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "Arduino.h"
+#include <Adafruit_GFX.h>
+#include <Max72xxPanel.h>
+#include "FrameLayer.h"
+
+// How a layer is combined with the layers below it.
+enum LayerBlend : uint8_t
+{
+  BLEND_OR,     // Lit pixels add to what is below (the usual case)
+  BLEND_XOR,    // Lit pixels invert what is below (cursor, highlight)
+  BLEND_MASK,   // Lit pixels switch off what is below (transition masks)
+  BLEND_REPLACE // The layer hides everything below within its window
+};
+
+const uint8_t COMPOSITOR_MAX_LAYERS = 4;
+
+// Stacks FrameLayers (clock, ticker, overlay icons, masks) bottom to top and
+// combines them into the Max72xxPanel bitmap once per frame. Each layer only
+// shows within its window of columns, which is how the display is split,
+// e.g. a compact clock on the left and a ticker on the right.
+//
+// Layers are combined a 32-column row word at a time and each composed
+// 8x8 block goes to the panel as row bytes (see Max72xxPanel::drawRows), so
+// the cost of a frame stays dominated by the SPI write even on a 16-module
+// chain.
+class Compositor
+{
+public:
+  explicit Compositor(Max72xxPanel &matrixRef);
+  ~Compositor();
+
+  // Stack a layer on top of those added before. Layers start visible over
+  // the full width. Returns the layer's index, or -1 when all slots are taken.
+  int8_t addLayer(FrameLayer &layer, LayerBlend blend);
+  void setVisible(uint8_t index, bool visible);
+  void setWindow(uint8_t index, int16_t x0, int16_t x1); // Columns [x0, x1)
+  void setBlend(uint8_t index, LayerBlend blend);
+
+  // Compose the visible layers into the panel bitmap and send it.
+  void present();
+  // Compose the visible layers into a panel-sized layer instead.
+  void composeInto(FrameLayer &target);
+
+private:
+  struct Entry
+  {
+    FrameLayer *layer;
+    LayerBlend blend;
+    int16_t x0;
+    int16_t x1;
+    bool visible;
+  };
+
+  Max72xxPanel &matrix;
+  Entry layers[COMPOSITOR_MAX_LAYERS];
+  uint8_t layerCount;
+  uint8_t words;   // Row words across the panel
+  uint32_t *band;  // The 8 composed rows of one band of modules
+
+  void windowsFor(uint8_t word, uint32_t *windows) const;
+  uint32_t composeWord(int16_t y, uint8_t word, const uint32_t *windows) const;
+
+  Compositor(const Compositor &) = delete;
+  Compositor &operator=(const Compositor &) = delete;
+};
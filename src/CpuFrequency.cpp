@@ -0,0 +1,70 @@
+#include "CpuFrequency.h"
+#include <user_interface.h>
+
+uint8_t CpuFrequency::boostDepth = 0;
+uint8_t CpuFrequency::currentMHz = CPU_IDLE_MHZ;
+uint32_t CpuFrequency::changes = 0;
+uint32_t CpuFrequency::windowBoosts = 0;
+unsigned long CpuFrequency::periodStart = 0;
+unsigned long CpuFrequency::idleMs = 0;
+unsigned long CpuFrequency::boostMs = 0;
+
+void CpuFrequency::boost()
+{
+  if (boostDepth++ == 0)
+  {
+    windowBoosts++;
+    setMHz(CPU_BOOST_MHZ);
+  }
+}
+
+void CpuFrequency::release()
+{
+  if (boostDepth == 0)
+  {
+    return;
+  }
+  if (--boostDepth == 0)
+  {
+    setMHz(CPU_IDLE_MHZ);
+  }
+}
+
+void CpuFrequency::setMHz(uint8_t mhz)
+{
+  if (mhz == currentMHz)
+  {
+    return;
+  }
+
+  // Close the period spent at the old frequency.
+  unsigned long now = millis();
+  (currentMHz == CPU_BOOST_MHZ ? boostMs : idleMs) += now - periodStart;
+  periodStart = now;
+
+  system_update_cpu_freq(mhz);
+  currentMHz = mhz;
+  changes++;
+}
+
+String CpuFrequency::toJson()
+{
+  unsigned long now = millis();
+  unsigned long current = now - periodStart;
+  unsigned long atIdle = idleMs + (currentMHz == CPU_IDLE_MHZ ? current : 0);
+  unsigned long atBoost = boostMs + (currentMHz == CPU_BOOST_MHZ ? current : 0);
+
+  String json = "{\"mhz\":" + String(currentMHz) + ",";
+  json += "\"ms_" + String(CPU_IDLE_MHZ) + "\":" + String(atIdle) + ",";
+  json += "\"ms_" + String(CPU_BOOST_MHZ) + "\":" + String(atBoost) + ",";
+  json += "\"boosts\":" + String(windowBoosts) + "}";
+  return json;
+}
+
+void CpuFrequency::reset()
+{
+  periodStart = millis();
+  idleMs = 0;
+  boostMs = 0;
+  windowBoosts = 0;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Arduino.h"
+
+const uint8_t CPU_IDLE_MHZ = 80;   // Default clock, used whenever nothing asks for more
+const uint8_t CPU_BOOST_MHZ = 160; // While scrolling, syncing time or receiving OTA
+
+// CPU frequency policy. Heavy work asks for the boost clock for its duration,
+// with a CpuBoost scope or a boost()/release() pair. The requests nest, and
+// the CPU drops back to CPU_IDLE_MHZ once the last one is released.
+//
+// Only the CPU clock changes. SPI, the UART and timer1 run from the fixed
+// 80 MHz APB clock, and millis()/micros() from the system timer, so none of
+// them need adjusting. Code that converts cycle counts (ESP.getCycleCount())
+// to time must use the frequency that was in effect. getChanges() tells
+// whether it changed in between.
+class CpuFrequency
+{
+public:
+  static void boost();
+  static void release();
+
+  static uint8_t getMHz() { return currentMHz; }
+  static uint32_t getChanges() { return changes; } // Frequency switches since boot
+
+  // {"mhz":..,"ms_80":..,"ms_160":..,"boosts":..} for the current metrics window
+  static String toJson();
+  static void reset(); // Start a new window (called after each MQTT publish)
+
+private:
+  static uint8_t boostDepth;
+  static uint8_t currentMHz;
+  static uint32_t changes;
+  static uint32_t windowBoosts;
+  static unsigned long periodStart;
+  static unsigned long idleMs;
+  static unsigned long boostMs;
+
+  static void setMHz(uint8_t mhz);
+};
+
+// Runs the enclosing scope at CPU_BOOST_MHZ.
+class CpuBoost
+{
+public:
+  CpuBoost() { CpuFrequency::boost(); }
+  ~CpuBoost() { CpuFrequency::release(); }
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include "Arduino.h"
+
+// Proportional font for the display encoding (see TextEncoding.h). Glyphs in
+// the PROGMEM atlas (printable ASCII and the extended Polish letters) are
+// drawn column by column at their own width. Other codes (accented CP437
+// letters, symbols) fall back to the fixed-width built-in Adafruit GFX font.
+const uint8_t FONT_HEIGHT = 8;
+const uint8_t FONT_MAX_WIDTH = 5;
+const uint8_t FONT_FALLBACK_WIDTH = 5; // Built-in font glyphs
+const uint8_t FONT_SPACING = 1;        // Blank column after every glyph
+const uint8_t FONT_ATLAS_SIZE = 0x80;  // The atlas covers codes 0x00-0x7F
+
+bool fontHasGlyph(uint8_t c);     // In the atlas (else draw the fallback)
+uint8_t fontGlyphWidth(uint8_t c); // Columns, without spacing; table lookup
+
+// The glyph's FONT_MAX_WIDTH column bytes in PROGMEM (bit 0 = top row); only
+// the first fontGlyphWidth(c) are used. c must be in the atlas.
+const uint8_t *fontGlyphColumns(uint8_t c);
+
+// Width of display-encoded text in pixels, spacing between glyphs included.
+int fontTextWidth(const char *text, size_t length);
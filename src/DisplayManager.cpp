@@ -1,11 +1,38 @@
 #include "DisplayManager.h"
 #include "Settings.h"
 #include "BackgroundService.h"
+#include "CpuFrequency.h"
+#include "TextEncoding.h"
+#include "DisplayFont.h"
+#include "FramePacer.h"
+#include <TimeLib.h>
 
 extern int refresh; // Global refresh flag from main
 
-DisplayManager::DisplayManager(Max72xxPanel &matrixRef) : matrix(matrixRef)
+DisplayManager::DisplayManager(Max72xxPanel &matrixRef)
+    : matrix(matrixRef), brightness(matrixRef), clockLayer(matrixRef.width(), matrixRef.height()),
+      contentLayer(matrixRef.width(), matrixRef.height()), transitionLayer(matrixRef.width(), matrixRef.height()),
+      overlayLayer(matrixRef.width(), matrixRef.height()), compositor(matrixRef), layout(LAYOUT_CONTENT),
+      fromLayer(matrixRef.width(), matrixRef.height()), toLayer(matrixRef.width(), matrixRef.height()),
+      transition(fromLayer, toLayer, transitionLayer), pendingTransition(TRANSITION_CUT), transitionFrameMs(0),
+      clockMinute(-2)
 {
+  clockSlot = compositor.addLayer(clockLayer, BLEND_OR);
+  contentSlot = compositor.addLayer(contentLayer, BLEND_OR);
+  transitionSlot = compositor.addLayer(transitionLayer, BLEND_REPLACE);
+  compositor.addLayer(overlayLayer, BLEND_OR);
+  compositor.setVisible(transitionSlot, false);
+  setLayout(LAYOUT_CONTENT);
+}
+
+void DisplayManager::setLayout(DisplayLayout newLayout)
+{
+  layout = newLayout;
+  int split = (layout == LAYOUT_SPLIT) ? compactClockFace.maxWidth() : 0;
+  compositor.setVisible(clockSlot, layout != LAYOUT_CONTENT);
+  compositor.setVisible(contentSlot, layout != LAYOUT_CLOCK);
+  compositor.setWindow(clockSlot, 0, split ? split : matrix.width());
+  compositor.setWindow(contentSlot, split ? split + 1 : 0, matrix.width()); // One blank column between
 }
 
 void DisplayManager::scrollMessage(const String &msg)
@@ -15,97 +42,279 @@ void DisplayManager::scrollMessage(const String &msg)
 
 void DisplayManager::scrollMessage(const String &msg, int speed)
 {
-  String scrollMsg = sanitizeText(msg) + " "; // add a space at the end
-  for (int i = 0; i < (int)(CHAR_WIDTH * scrollMsg.length() + matrix.width() - 1 - SPACER); i++)
+  scrollMessage(msg, {scrollVelocityFromDelay(speed), SCROLL_CONSTANT, false});
+}
+
+void DisplayManager::scrollMessage(const String &msg, const ScrollStyle &style)
+{
+  String text = sanitizeText(msg);
+  StringTextSource source(text);
+  scrollText(source, style);
+}
+
+void DisplayManager::scrollText(TextSource &text, const ScrollStyle &style)
+{
+  CpuBoost boost; // Smooth fast scrolls while the network is pumped in between
+  endTransition(); // The text scrolling in is the transition
+  unsigned int textLength = text.length();
+  int y = (matrix.height() - FONT_HEIGHT) / 2; // center the text vertically
+
+  // The text enters at the right edge and leaves at the left edge of the
+  // content window.
+  bool withClock = style.withClock;
+  setLayout(withClock ? LAYOUT_SPLIT : LAYOUT_CONTENT);
+  int left = withClock ? compactClockFace.maxWidth() + 1 : 0;
+  int right = matrix.width();
+
+  // Easing needs the whole distance up front: across the window, plus the text.
+  uint32_t distance = 0;
+  if (style.profile == SCROLL_EASED)
+  {
+    distance = right - left;
+    for (unsigned int i = 0; i < textLength; i++)
+    {
+      distance += glyphAdvance(text.charAt(i));
+    }
+  }
+  ScrollMotion motion(style.velocity, style.profile, distance);
+
+  // One frame per column at full speed, but no more than DISPLAY_MAX_FPS;
+  // faster speeds move several columns per frame. Each frame reads the
+  // position for the middle of its period, so the small jitter of the frame
+  // clock never rounds a column into the next frame.
+  unsigned long periodMs = max(motion.pixelPeriodMs(), 1000UL / DISPLAY_MAX_FPS);
+  unsigned long elapsedMs = 0;
+  long scrolled = 0;
+
+  // The picture slides left with a row-word shift, and only the glyphs at
+  // the right edge are drawn again, so a frame costs the same however long
+  // the text or wide the panel. Glyphs have different widths, so the first
+  // glyph still on screen and the first one not yet fully drawn are tracked
+  // along with their left edges.
+  unsigned int first = 0;
+  int firstX = right;
+  unsigned int edge = 0;
+  int edgeX = right;
+  contentLayer.fillScreen(LOW);
+  FramePacer::start(periodMs);
+  while (true)
   {
     if (refresh == 1)
     {
-      i = 0;
+      first = edge = 0;
+      firstX = edgeX = right;
+      contentLayer.fillScreen(LOW);
+      FramePacer::start(periodMs);
+      elapsedMs = 0;
+      scrolled = 0;
     }
     refresh = 0;
-    matrix.fillScreen(LOW);
 
-    int letter = i / CHAR_WIDTH;
-    int x = (matrix.width() - 1) - i % CHAR_WIDTH;
-    int y = (matrix.height() - 8) / 2; // center the text vertically
+    int step = (int)(motion.position(elapsedMs + periodMs / 2) + 1 - scrolled);
+    if (step <= 0)
+    {
+      elapsedMs = FramePacer::waitForFrame();
+      continue; // Early frame; the text hasn't moved a whole column yet
+    }
+    scrolled += step;
+    contentLayer.scrollLeft(left, right, step);
+    firstX -= step;
+    edgeX -= step;
+    while (first < textLength && firstX + glyphAdvance(text.charAt(first)) <= left)
+    {
+      firstX += glyphAdvance(text.charAt(first++));
+    }
+    if (edge < first)
+    {
+      edge = first; // Jumped past glyphs that never needed drawing
+      edgeX = firstX;
+    }
+
+    int x = edgeX;
+    for (unsigned int letter = edge; letter < textLength && x < right; letter++)
+    {
+      x += drawGlyph(contentLayer, x, y, text.charAt(letter));
+    }
+    while (edge < textLength && edgeX + glyphAdvance(text.charAt(edge)) <= right)
+    {
+      edgeX += glyphAdvance(text.charAt(edge++));
+    }
 
-    while (x + CHAR_WIDTH - SPACER >= 0 && letter >= 0)
+    if (withClock)
     {
-      if (letter < (int)scrollMsg.length())
-      {
-        matrix.drawChar(x, y, scrollMsg[letter], HIGH, LOW, 1);
-      }
-      letter--;
-      x -= CHAR_WIDTH;
+      // The colon stays lit; a blinking one next to moving text is a distraction.
+      int clockHour = (timeStatus() == timeNotSet) ? -1 : hour();
+      compactClockFace.render(clockLayer, 0, left - 1, clockHour, minute(), second(), true);
     }
 
-    matrix.write();       // Send bitmap to display
-    serviceDelay(speed);  // Wait per-step while keeping background services alive
+    compositor.present(); // Compose the layers and send the frame
+    if (first >= textLength)
+    {
+      break; // The text has fully cleared
+    }
+    elapsedMs = FramePacer::waitForFrame(); // Keeps background services alive while waiting
   }
-  matrix.setCursor(0, 0);
+  FramePacer::stop();
 }
 
 void DisplayManager::centerPrint(const String &msg)
 {
   String text = sanitizeText(msg);
-  int x = calculateCenterX(text.length());
-  matrix.setCursor(x, 0);
-  matrix.print(text);
-  matrix.write();
+  int x = calculateCenterX(text);
+  setLayout(LAYOUT_CONTENT);
+  for (unsigned int i = 0; i < text.length(); i++)
+  {
+    x += drawGlyph(contentLayer, x, 0, text[i]);
+  }
+  present();
 }
 
-void DisplayManager::fadeMessage(int targetBrightness, int stepDelayMs)
+void DisplayManager::showClock(int hour, int minute, int second, bool colon)
 {
-  targetBrightness = constrain(targetBrightness, 0, 15);
+  int shownMinute = (hour < 0) ? -1 : minute;
+  if (layout != LAYOUT_CLOCK)
+  {
+    transitionNext(TRANSITION_WIPE); // Back from a notification
+  }
+  else if (shownMinute != clockMinute)
+  {
+    transitionNext(TRANSITION_SLIDE);
+  }
+  clockMinute = shownMinute;
+
+  setLayout(LAYOUT_CLOCK);
+  clockFace.render(clockLayer, 0, matrix.width(), hour, minute, second, colon);
+  present();
+}
 
-  // Fade out
-  for (int level = targetBrightness; level >= 0; level--)
+void DisplayManager::transitionNext(TransitionEffect effect)
+{
+  if (!DISPLAY_TRANSITIONS || effect == TRANSITION_CUT)
   {
-    matrix.setIntensity(level);
-    delay(stepDelayMs);
+    return;
   }
-  // Fade back in
-  for (int level = 0; level <= targetBrightness; level++)
+  compositor.composeInto(fromLayer); // What is on screen, a running transition included
+  pendingTransition = effect;
+}
+
+void DisplayManager::present()
+{
+  if (pendingTransition != TRANSITION_CUT || transition.isRunning())
   {
-    matrix.setIntensity(level);
-    delay(stepDelayMs);
+    // The target is everything below the transition layer, recomposed on
+    // every draw so it stays live (the clock keeps ticking underneath).
+    compositor.setVisible(transitionSlot, false);
+    compositor.composeInto(toLayer);
+    compositor.setVisible(transitionSlot, true);
+    if (pendingTransition != TRANSITION_CUT)
+    {
+      transition.begin(pendingTransition);
+      pendingTransition = TRANSITION_CUT;
+      transitionFrameMs = millis();
+    }
+    else
+    {
+      transition.render();
+    }
   }
+  compositor.present();
 }
 
-void DisplayManager::performBrightnessAnimation()
+void DisplayManager::tickTransition()
 {
-  // Fade in
-  for (int inx = 0; inx <= 15; inx++)
+  if (!transition.isRunning() || millis() - transitionFrameMs < TRANSITION_FRAME_MS)
   {
-    matrix.setIntensity(inx);
-    delay(50);
+    return;
   }
-  // Fade out
-  for (int inx = 15; inx >= 0; inx--)
+  transitionFrameMs = millis();
+  if (!transition.step())
   {
-    matrix.setIntensity(inx);
-    delay(50);
+    compositor.setVisible(transitionSlot, false);
   }
-  delay(500);
+  compositor.present();
+}
+
+void DisplayManager::endTransition()
+{
+  transition.finish();
+  pendingTransition = TRANSITION_CUT;
+  compositor.setVisible(transitionSlot, false);
+}
+
+int DisplayManager::glyphAdvance(unsigned char c)
+{
+  return fontGlyphWidth(c) + FONT_SPACING;
+}
+
+int DisplayManager::drawGlyph(FrameLayer &layer, int x, int y, unsigned char c)
+{
+  if (!fontHasGlyph(c))
+  {
+    // Fixed-width built-in glyph; drawChar() adds the spacing column itself.
+    layer.drawChar(x, y, c, HIGH, LOW, 1);
+    return FONT_FALLBACK_WIDTH + FONT_SPACING;
+  }
+
+  // Atlas glyph: blit its columns, then the blank spacing column.
+  const uint8_t *columns = fontGlyphColumns(c);
+  uint8_t width = fontGlyphWidth(c);
+  for (uint8_t col = 0; col < width; col++)
+  {
+    layer.drawColumn(x + col, y, pgm_read_byte(&columns[col]));
+  }
+  layer.drawColumn(x + width, y, 0);
+  return width + FONT_SPACING;
+}
+
+void DisplayManager::fadeMessage(int targetBrightness, int stepDelayMs)
+{
+  targetBrightness = constrain(targetBrightness, 0, 15);
+  unsigned long halfMs = (unsigned long)(targetBrightness + 1) * stepDelayMs;
+  brightness.queue(0, halfMs, EASE_IN_OUT);
+  brightness.queue(targetBrightness, halfMs, EASE_IN_OUT);
+}
+
+void DisplayManager::performBrightnessAnimation()
+{
+  brightness.set(0);
+  brightness.queue(15, 800, EASE_IN_OUT);
+  brightness.queue(0, 800, EASE_IN_OUT);
+  brightness.hold(500);
+  brightness.queue(DISPLAY_INTENSITY, 300, EASE_OUT);
 }
 
 void DisplayManager::showUpdateIndicator()
 {
-  matrix.drawPixel(0, 4, HIGH);
-  matrix.drawPixel(0, 3, HIGH);
-  matrix.drawPixel(0, 2, HIGH);
-  matrix.write();
+  overlayLayer.drawPixel(0, 4, HIGH);
+  overlayLayer.drawPixel(0, 3, HIGH);
+  overlayLayer.drawPixel(0, 2, HIGH);
+  present();
+}
+
+void DisplayManager::hideUpdateIndicator()
+{
+  overlayLayer.fillScreen(LOW);
+  present();
 }
 
 void DisplayManager::initializeMatrix()
 {
   Serial.println("Number of LED Displays: " + String(NUMBER_OF_HORIZONTAL_DISPLAYS));
-  matrix.setIntensity(0); // Start with brightness 0
+  brightness.set(0); // Start with brightness 0
 
   // Use real CP437 mapping so high-range glyphs (e.g. the degree sign at
   // 0xF8) render correctly. Without this, Adafruit GFX shifts every byte
   // >= 0xB0 by one and prints the wrong character.
-  matrix.cp437(true);
+  contentLayer.cp437(true);
+
+  // Re-assert the control registers now and then, in case a supply glitch
+  // reset or garbled a module.
+  matrix.setRefreshInterval(DISPLAY_REFRESH_INTERVAL_MS);
+
+  clockFace.setStyle((ClockDigitStyle)CLOCK_DIGIT_STYLE, CLOCK_SECONDS_BAR);
+  // Next to other content a short chain keeps the clock to 3x5 digits (17
+  // columns), leaving the rest for the ticker.
+  compactClockFace.setStyle(matrix.width() < 64 ? CLOCK_DIGITS_TINY : (ClockDigitStyle)CLOCK_DIGIT_STYLE, false);
 
   // Configure matrix panels
   int maxPos = NUMBER_OF_HORIZONTAL_DISPLAYS * NUMBER_OF_VERTICAL_DISPLAYS;
@@ -116,56 +325,55 @@ void DisplayManager::initializeMatrix()
   }
 
   Serial.println("Matrix initialized");
-  matrix.fillScreen(LOW);
+  fillScreen(LOW);
   centerPrint("Witaj");
 }
 
 void DisplayManager::setIntensity(int intensity)
 {
-  matrix.setIntensity(intensity);
+  brightness.set(intensity);
+}
+
+void DisplayManager::fadeIntensityTo(int intensity, unsigned long durationMs)
+{
+  brightness.retarget(intensity, durationMs);
 }
 
 void DisplayManager::fillScreen(bool state)
 {
-  matrix.fillScreen(state);
+  setLayout(LAYOUT_CONTENT);
+  contentLayer.fillScreen(state);
 }
 
 void DisplayManager::write()
 {
-  matrix.write();
+  present();
 }
 
-int DisplayManager::calculateCenterX(int textLength)
+int DisplayManager::calculateCenterX(const String &text)
 {
-  return (matrix.width() - (textLength * CHAR_WIDTH)) / 2;
+  return (matrix.width() - fontTextWidth(text.c_str(), text.length())) / 2;
 }
 
 String DisplayManager::sanitizeText(const String &msg)
 {
   String out;
-  out.reserve(msg.length());
-
-  for (unsigned int i = 0; i < msg.length(); i++)
+  if (!out.reserve(msg.length())) // Never longer than the UTF-8 input
   {
-    unsigned char c = (unsigned char)msg[i];
-
-    // UTF-8 degree sign (U+00B0) arrives as the two bytes 0xC2 0xB0.
-    if (c == 0xC2 && (i + 1) < msg.length() && (unsigned char)msg[i + 1] == 0xB0)
-    {
-      out += (char)0xF8; // CP437 degree glyph
-      i++;               // skip the trailing 0xB0
-      continue;
-    }
-
-    // Bare Latin-1 degree byte, just in case a client sends it un-encoded.
-    if (c == 0xB0)
-    {
-      out += (char)0xF8;
-      continue;
-    }
-
-    out += (char)c;
+    return out;
   }
 
+  // Transcode through a small stack buffer and append it in blocks.
+  char block[64];
+  const char *in = msg.c_str();
+  size_t remaining = msg.length();
+  while (remaining > 0)
+  {
+    size_t consumed;
+    size_t written = utf8ToCp437(in, remaining, block, sizeof(block), &consumed);
+    out.concat(block, written);
+    in += consumed;
+    remaining -= consumed;
+  }
   return out;
 }
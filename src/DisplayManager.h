@@ -2,6 +2,22 @@
 #include "Arduino.h"
 #include <Adafruit_GFX.h>
 #include <Max72xxPanel.h>
+#include "TextSource.h"
+#include "BrightnessAnimator.h"
+#include "ClockFace.h"
+#include "FrameLayer.h"
+#include "Compositor.h"
+#include "ScrollMotion.h"
+#include "Transition.h"
+
+// What the compositor shows: the clock, other content (text, animations) or
+// a compact clock on the left with the content beside it.
+enum DisplayLayout : uint8_t
+{
+  LAYOUT_CLOCK,
+  LAYOUT_CONTENT,
+  LAYOUT_SPLIT
+};
 
 class DisplayManager
 {
@@ -10,34 +26,90 @@ public:
 
   // Display operations
   void scrollMessage(const String &msg);
-  void scrollMessage(const String &msg, int speed); // Overloaded version with custom speed
+  void scrollMessage(const String &msg, int speed); // Overloaded version with custom speed (ms per pixel)
+  void scrollMessage(const String &msg, const ScrollStyle &style);
+  // Scroll already-encoded text from any source (e.g. a LittleFS-backed
+  // stored notification) without materialising it as a String.
+  void scrollText(TextSource &text, const ScrollStyle &style);
   void centerPrint(const String &msg);
-  // Fade the currently displayed content out (to 0) and back in (to
-  // targetBrightness), stepDelayMs per intensity step. The content is not
-  // redrawn, only the panel intensity is modulated.
+  // Draw the clock face (hour < 0 while the time is unknown). Changed
+  // digits slide in on a new minute, and the clock wipes in when it comes
+  // back from other content (see DISPLAY_TRANSITIONS).
+  void showClock(int hour, int minute, int second, bool colon);
+  // Blend from what is on screen now to whatever is drawn next, instead of
+  // cutting to it. The effect then plays out from tickTransition().
+  void transitionNext(TransitionEffect effect);
+  void tickTransition();
+  bool isTransitionRunning() const { return transition.isRunning(); }
+  // Queue one fade of the current content out (to 0) and back in (to
+  // targetBrightness), taking stepDelayMs per intensity step each way. Returns
+  // at once; the content is not redrawn, only the intensity is modulated.
   void fadeMessage(int targetBrightness, int stepDelayMs);
+  // Queue the boot intro (fade up, fade down, pause, fade to
+  // DISPLAY_INTENSITY). Returns at once.
   void performBrightnessAnimation();
+  // Overlay marker shown over whatever is on screen while the time syncs.
   void showUpdateIndicator();
+  void hideUpdateIndicator();
   void initializeMatrix();
 
   // Display configuration
-  void setIntensity(int intensity);
+  void setIntensity(int intensity); // Immediate; cancels any transition
+  // Ease to a new intensity. A running sequence (intro, flash) keeps playing
+  // and ends at the new level instead.
+  void fadeIntensityTo(int intensity, unsigned long durationMs);
+  void tickBrightness() { brightness.tick(); }
+  bool isBrightnessAnimating() const { return brightness.isAnimating(); }
+  unsigned long brightnessAnimationRemainingMs() const { return brightness.remainingMs(); }
+  // One step of the periodic panel register refresh (see
+  // DISPLAY_REFRESH_INTERVAL_MS). Call between frames.
+  void refreshPanelStep() { matrix.refreshStep(); }
+  // Content drawing: fillScreen() and getCanvas() draw on the content layer
+  // (switching the display to it), write() composes the layers and sends
+  // the frame.
   void fillScreen(bool state);
   void write();
-  Max72xxPanel &getMatrix() { return matrix; }
+  FrameLayer &getCanvas() { return contentLayer; }
+
+  // Convert UTF-8 payloads (e.g. from MQTT) into the single-byte display
+  // encoding: CP437 plus the extended Polish glyphs (see TextEncoding.h).
+  static String sanitizeText(const String &msg);
 
 private:
   Max72xxPanel &matrix;
+  BrightnessAnimator brightness;
+  ClockFace clockFace;
+  ClockFace compactClockFace; // The clock in LAYOUT_SPLIT
 
-  // Constants
-  static const int FONT_WIDTH = 5;
-  static const int SPACER = 1;
-  static const int CHAR_WIDTH = FONT_WIDTH + SPACER;
+  // Layers, bottom to top
+  FrameLayer clockLayer;
+  FrameLayer contentLayer;
+  FrameLayer transitionLayer; // Replaces the layers below while a transition runs
+  FrameLayer overlayLayer;
+  Compositor compositor;
+  int8_t clockSlot;
+  int8_t contentSlot;
+  int8_t transitionSlot;
+  DisplayLayout layout;
 
-  // Helper functions
-  int calculateCenterX(int textLength);
+  // Frame transitions: the frames before and after, blended into transitionLayer
+  FrameLayer fromLayer;
+  FrameLayer toLayer;
+  Transition transition;
+  TransitionEffect pendingTransition;
+  unsigned long transitionFrameMs;
+  int clockMinute; // Minute on the clock face, -1 for "--:--"
+
+  void setLayout(DisplayLayout newLayout);
+  // Send the composed frame, starting or updating a transition if one is
+  // pending or running.
+  void present();
+  void endTransition();
 
-  // Convert UTF-8 payloads (e.g. from MQTT) into the single-byte CP437 codes
-  // the LED font uses. Currently maps the degree sign; extend as needed.
-  String sanitizeText(const String &msg);
+  // Helper functions
+  int calculateCenterX(const String &text); // text is display-encoded
+  // Draw one display-encoded character in the proportional font (see
+  // DisplayFont.h), spacing column included; returns the advance in pixels.
+  int drawGlyph(FrameLayer &layer, int x, int y, unsigned char c);
+  static int glyphAdvance(unsigned char c);
 };
@@ -0,0 +1,116 @@
+#include "FrameLayer.h"
+
+uint32_t columnMask(int16_t x0, int16_t x1, uint8_t word)
+{
+  int16_t first = word * 32;
+  x0 = max(x0, first);
+  x1 = min(x1, (int16_t)(first + 32));
+  if (x0 >= x1)
+  {
+    return 0;
+  }
+  uint32_t fromX0 = 0xFFFFFFFFUL >> (x0 - first);
+  uint32_t beforeX1 = (x1 - first == 32) ? 0xFFFFFFFFUL : ~(0xFFFFFFFFUL >> (x1 - first));
+  return fromX0 & beforeX1;
+}
+
+FrameLayer::FrameLayer(int16_t width, int16_t height) : Adafruit_GFX(width, height), wordsPerRow((width + 31) / 32)
+{
+  rows = new uint32_t[height * wordsPerRow];
+  fillScreen(0);
+}
+
+FrameLayer::~FrameLayer()
+{
+  delete[] rows;
+}
+
+void FrameLayer::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+  if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT)
+  {
+    return;
+  }
+
+  uint32_t &word = rows[y * wordsPerRow + (x >> 5)];
+  uint32_t mask = 0x80000000UL >> (x & 31);
+  if (color)
+  {
+    word |= mask;
+  }
+  else
+  {
+    word &= ~mask;
+  }
+}
+
+void FrameLayer::fillScreen(uint16_t color)
+{
+  memset(rows, color ? 0xFF : 0x00, HEIGHT * wordsPerRow * sizeof(uint32_t));
+}
+
+void FrameLayer::drawColumn(int16_t x, int16_t y, uint8_t bits)
+{
+  if (x < 0 || x >= WIDTH)
+  {
+    return;
+  }
+
+  uint32_t mask = 0x80000000UL >> (x & 31);
+  for (uint8_t i = 0; i < 8; i++, bits >>= 1)
+  {
+    int16_t py = y + i;
+    if (py < 0 || py >= HEIGHT)
+    {
+      continue;
+    }
+    uint32_t &word = rows[py * wordsPerRow + (x >> 5)];
+    word = (bits & 1) ? (word | mask) : (word & ~mask);
+  }
+}
+
+void FrameLayer::clearColumns(int16_t x0, int16_t x1)
+{
+  for (uint8_t w = 0; w < wordsPerRow; w++)
+  {
+    uint32_t keep = ~columnMask(x0, x1, w);
+    for (int16_t y = 0; y < HEIGHT; y++)
+    {
+      rows[y * wordsPerRow + w] &= keep;
+    }
+  }
+}
+
+void FrameLayer::scrollLeft(int16_t x0, int16_t x1, int16_t n)
+{
+  if (n <= 0)
+  {
+    return;
+  }
+  if (n >= x1 - x0)
+  {
+    clearColumns(x0, x1);
+    return;
+  }
+
+  // A multi-word shift of each row, merged back within the range: columns
+  // [x0, x1 - n) take the shifted bits, [x1 - n, x1) are cleared.
+  uint8_t skip = n >> 5;
+  uint8_t shift = n & 31;
+  for (int16_t y = 0; y < HEIGHT; y++)
+  {
+    uint32_t *r = rows + y * wordsPerRow;
+    for (uint8_t w = 0; w < wordsPerRow; w++)
+    {
+      uint32_t range = columnMask(x0, x1, w);
+      if (!range)
+      {
+        continue;
+      }
+      uint32_t high = (w + skip < wordsPerRow) ? r[w + skip] : 0;
+      uint32_t low = (w + skip + 1 < wordsPerRow) ? r[w + skip + 1] : 0;
+      uint32_t shifted = shift ? (high << shift) | (low >> (32 - shift)) : high;
+      r[w] = (r[w] & ~range) | (shifted & columnMask(x0, x1 - n, w));
+    }
+  }
+}
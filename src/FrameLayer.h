@@ -0,0 +1,44 @@
+#pragma once
+#include "Arduino.h"
+#include <Adafruit_GFX.h>
+
+// Bits for columns [x0, x1) within row word `word` (column 32 * word in
+// the top bit).
+uint32_t columnMask(int16_t x0, int16_t x1, uint8_t word);
+
+// One 1-bit drawing surface the size of the panel, composed onto the
+// MAX7219 bitmap by the Compositor. Each row is kept as 32-bit words, one
+// bit per column with the leftmost column in the top bit (a 4-module panel
+// is one word per row, longer chains use more). Sliding the picture
+// sideways or blanking a range of columns is then a shift or a mask per
+// row word instead of a pass over every pixel. Being an Adafruit_GFX
+// canvas, every GFX primitive (lines, drawChar for the built-in font)
+// works on it too.
+class FrameLayer : public Adafruit_GFX
+{
+public:
+  FrameLayer(int16_t width, int16_t height);
+  ~FrameLayer();
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+
+  // Set the 8 pixels from (x, y) down at once (bit 0 = top pixel).
+  void drawColumn(int16_t x, int16_t y, uint8_t bits);
+  // Clear columns [x0, x1) on every row.
+  void clearColumns(int16_t x0, int16_t x1);
+  // Move columns [x0, x1) left by n; the n columns at the right end of the
+  // range are left blank, the rest of the layer is untouched.
+  void scrollLeft(int16_t x0, int16_t x1, int16_t n);
+
+  uint8_t words() const { return wordsPerRow; }
+  const uint32_t *row(int16_t y) const { return rows + y * wordsPerRow; }
+  uint32_t *row(int16_t y) { return rows + y * wordsPerRow; }
+
+private:
+  uint32_t *rows; // rows[y * wordsPerRow + word]
+  uint8_t wordsPerRow;
+
+  FrameLayer(const FrameLayer &) = delete;
+  FrameLayer &operator=(const FrameLayer &) = delete;
+};
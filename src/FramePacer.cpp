@@ -0,0 +1,75 @@
+#include "FramePacer.h"
+#include "BackgroundService.h"
+
+Ticker FramePacer::ticker;
+volatile bool FramePacer::frameDue = false;
+uint32_t FramePacer::periodUs = 0;
+uint32_t FramePacer::startUs = 0;
+uint32_t FramePacer::frameIndex = 0;
+uint32_t FramePacer::frames = 0;
+uint32_t FramePacer::dropped = 0;
+Histogram FramePacer::jitterUs;
+
+void FramePacer::onTick()
+{
+  frameDue = true;
+}
+
+void FramePacer::start(unsigned long periodMs)
+{
+  periodUs = periodMs * 1000UL;
+  startUs = micros();
+  frameIndex = 0;
+  frameDue = false;
+  ticker.attach_ms(periodMs, onTick);
+}
+
+void FramePacer::stop()
+{
+  ticker.detach();
+}
+
+unsigned long FramePacer::waitForFrame()
+{
+  while (!frameDue)
+  {
+    serviceBackground();
+    if (!frameDue)
+    {
+      delay(1); // Lets the Ticker callback run
+    }
+  }
+  frameDue = false;
+
+  // Snap to the nearest grid slot: the Ticker runs on its own millisecond
+  // timer, so its marks drift a little around the slots.
+  uint32_t elapsedUs = micros() - startUs;
+  uint32_t index = (elapsedUs + periodUs / 2) / periodUs;
+  if (index <= frameIndex)
+  {
+    index = frameIndex + 1; // Marked early; this is simply the next frame
+  }
+  dropped += index - frameIndex - 1;
+  frameIndex = index;
+  frames++;
+
+  uint32_t slotUs = index * periodUs;
+  jitterUs.record(elapsedUs > slotUs ? elapsedUs - slotUs : slotUs - elapsedUs);
+  return elapsedUs / 1000;
+}
+
+String FramePacer::toJson()
+{
+  String json = "{\"period_ms\":" + String(periodUs / 1000UL) + ",";
+  json += "\"n\":" + String(frames) + ",";
+  json += "\"dropped\":" + String(dropped) + ",";
+  json += "\"jitter_us\":" + jitterUs.toJson() + "}";
+  return json;
+}
+
+void FramePacer::reset()
+{
+  frames = 0;
+  dropped = 0;
+  jitterUs.reset();
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "Arduino.h"
+#include <Ticker.h>
+#include "Histogram.h"
+
+// Frame clock for scrolling text. A Ticker marks each frame period in the
+// background; waitForFrame() keeps the network serviced until the next mark
+// and returns the time since start(), so callers place content by elapsed
+// time rather than by counting frames. A frame held up by a slow
+// handleClient() or MQTT packet then catches up on the next one instead of
+// slowing the message down.
+//
+// Frames are counted on a fixed grid from start(). A frame that lands one or
+// more grid slots late counts the skipped slots as dropped; its distance
+// from its slot is recorded as jitter.
+class FramePacer
+{
+public:
+  static void start(unsigned long periodMs); // Frame 0 is now
+  static void stop();
+
+  // Service the background until the next frame is due; returns the ms
+  // since start().
+  static unsigned long waitForFrame();
+
+  // {"period_ms":..,"n":..,"dropped":..,"jitter_us":{histogram}} for the
+  // current metrics window (period of the latest sequence)
+  static String toJson();
+  static bool hasFrames() { return frames > 0; }
+  static void reset(); // Start a new window (called after each MQTT publish)
+
+private:
+  static Ticker ticker;
+  static volatile bool frameDue;
+  static uint32_t periodUs;
+  static uint32_t startUs;
+  static uint32_t frameIndex; // Grid slot of the last frame
+  static uint32_t frames;
+  static uint32_t dropped;
+  static Histogram jitterUs;
+
+  static void onTick();
+};
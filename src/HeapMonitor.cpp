@@ -0,0 +1,102 @@
+#include "HeapMonitor.h"
+
+uint32_t HeapMonitor::freeHeap = 0;
+uint32_t HeapMonitor::maxFreeBlock = 0;
+uint8_t HeapMonitor::fragmentation = 0;
+uint32_t HeapMonitor::minFreeHeap = 0xFFFFFFFFUL;
+uint32_t HeapMonitor::minMaxFreeBlock = 0xFFFFFFFFUL;
+uint8_t HeapMonitor::maxFragmentation = 0;
+unsigned long HeapMonitor::lastSample = 0;
+
+#ifdef HEAP_AUDIT
+HeapSubsystem HeapMonitor::current = HEAP_OTHER;
+uint32_t HeapMonitor::allocations[HEAP_SUBSYSTEM_COUNT] = {};
+uint32_t HeapMonitor::allocatedBytes[HEAP_SUBSYSTEM_COUNT] = {};
+
+static const char *const HEAP_SUBSYSTEM_NAMES[HEAP_SUBSYSTEM_COUNT] = {"other", "display", "mqtt", "web", "time"};
+#endif
+
+void HeapMonitor::sample()
+{
+  lastSample = millis();
+
+  // One call reads all three consistently.
+  ESP.getHeapStats(&freeHeap, &maxFreeBlock, &fragmentation);
+
+  if (freeHeap < minFreeHeap)
+  {
+    minFreeHeap = freeHeap;
+  }
+  if (maxFreeBlock < minMaxFreeBlock)
+  {
+    minMaxFreeBlock = maxFreeBlock;
+  }
+  if (fragmentation > maxFragmentation)
+  {
+    maxFragmentation = fragmentation;
+  }
+}
+
+String HeapMonitor::toJson()
+{
+  if (lastSample == 0)
+  {
+    sample();
+  }
+
+  char buffer[128];
+  snprintf(buffer, sizeof(buffer),
+           "{\"free\":%lu,\"max_block\":%lu,\"frag\":%u,\"min_free\":%lu,\"min_max_block\":%lu,\"max_frag\":%u",
+           (unsigned long)freeHeap, (unsigned long)maxFreeBlock, fragmentation, (unsigned long)minFreeHeap,
+           (unsigned long)minMaxFreeBlock, maxFragmentation);
+  String json = buffer;
+
+#ifdef HEAP_AUDIT
+  json += ",\"alloc\":{";
+  for (int i = 0; i < HEAP_SUBSYSTEM_COUNT; i++)
+  {
+    snprintf(buffer, sizeof(buffer), "%s\"%s\":{\"n\":%lu,\"bytes\":%lu}", i ? "," : "", HEAP_SUBSYSTEM_NAMES[i],
+             (unsigned long)allocations[i], (unsigned long)allocatedBytes[i]);
+    json += buffer;
+  }
+  json += "}";
+#endif
+
+  json += "}";
+  return json;
+}
+
+#ifdef HEAP_AUDIT
+void IRAM_ATTR HeapMonitor::countAllocation(size_t size)
+{
+  allocations[current]++;
+  allocatedBytes[current] += size;
+}
+
+// Link-time wrappers (-Wl,--wrap=malloc etc.): every allocation in the
+// firmware, core and libraries included, passes through here first.
+extern "C"
+{
+  void *__real_malloc(size_t size);
+  void *__real_calloc(size_t count, size_t size);
+  void *__real_realloc(void *ptr, size_t size);
+
+  void *IRAM_ATTR __wrap_malloc(size_t size)
+  {
+    HeapMonitor::countAllocation(size);
+    return __real_malloc(size);
+  }
+
+  void *IRAM_ATTR __wrap_calloc(size_t count, size_t size)
+  {
+    HeapMonitor::countAllocation(count * size);
+    return __real_calloc(count, size);
+  }
+
+  void *IRAM_ATTR __wrap_realloc(void *ptr, size_t size)
+  {
+    HeapMonitor::countAllocation(size);
+    return __real_realloc(ptr, size);
+  }
+}
+#endif
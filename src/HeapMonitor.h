@@ -0,0 +1,83 @@
+#pragma once
+#include "Arduino.h"
+
+// Heap telemetry. sample() runs as a periodic scheduler task and records the
+// current free heap, the largest allocatable block and the core's
+// fragmentation metric (0-100 %), plus their worst values since boot. The
+// low-water marks are what matter for a slow leak or fragmentation drift over
+// weeks; a single free-heap reading hides both.
+//
+// Building with -DHEAP_AUDIT (env:d1_mini_heap_audit, which also wraps
+// malloc/calloc/realloc at link time) additionally counts allocations per
+// subsystem. Code tags itself with HEAP_AUDIT_SCOPE(HEAP_MQTT) etc.; without
+// HEAP_AUDIT the macro compiles to nothing.
+
+const unsigned long HEAP_SAMPLE_INTERVAL_MS = 10000UL; // How often the heap is sampled
+
+enum HeapSubsystem : uint8_t
+{
+  HEAP_OTHER,
+  HEAP_DISPLAY,
+  HEAP_MQTT,
+  HEAP_WEB,
+  HEAP_TIME,
+  HEAP_SUBSYSTEM_COUNT
+};
+
+class HeapMonitor
+{
+public:
+  static void sample(); // Scheduled every HEAP_SAMPLE_INTERVAL_MS
+
+  static uint32_t getFreeHeap() { return freeHeap; }
+  static uint32_t getMaxFreeBlock() { return maxFreeBlock; }
+  static uint8_t getFragmentation() { return fragmentation; }
+  static uint32_t getMinFreeHeap() { return minFreeHeap; }
+  static uint32_t getMinMaxFreeBlock() { return minMaxFreeBlock; }
+  static uint8_t getMaxFragmentation() { return maxFragmentation; }
+
+  // {"free":..,"max_block":..,"frag":..,"min_free":..,"min_max_block":..,"max_frag":..}
+  // plus "alloc":{"display":{"n":..,"bytes":..},...} in HEAP_AUDIT builds.
+  static String toJson();
+
+#ifdef HEAP_AUDIT
+  static void countAllocation(size_t size); // Called from the malloc wrappers
+  static HeapSubsystem current;             // Subsystem charged for allocations right now
+#endif
+
+private:
+  static uint32_t freeHeap;
+  static uint32_t maxFreeBlock;
+  static uint8_t fragmentation;
+  static uint32_t minFreeHeap;
+  static uint32_t minMaxFreeBlock;
+  static uint8_t maxFragmentation;
+  static unsigned long lastSample;
+
+#ifdef HEAP_AUDIT
+  static uint32_t allocations[HEAP_SUBSYSTEM_COUNT];
+  static uint32_t allocatedBytes[HEAP_SUBSYSTEM_COUNT];
+#endif
+};
+
+#ifdef HEAP_AUDIT
+// Charges every allocation made while in scope to `subsystem`.
+class HeapAuditScope
+{
+public:
+  explicit HeapAuditScope(HeapSubsystem subsystem) : previous(HeapMonitor::current)
+  {
+    HeapMonitor::current = subsystem;
+  }
+  ~HeapAuditScope() { HeapMonitor::current = previous; }
+
+private:
+  HeapSubsystem previous;
+};
+#define HEAP_AUDIT_SCOPE(subsystem) HeapAuditScope heapAuditScope_(subsystem)
+#else
+#define HEAP_AUDIT_SCOPE(subsystem) \
+  do                                \
+  {                                 \
+  } while (0)
+#endif
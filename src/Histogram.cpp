@@ -0,0 +1,79 @@
+#include "Histogram.h"
+
+Histogram::Histogram()
+{
+  reset();
+}
+
+void Histogram::reset()
+{
+  memset(buckets, 0, sizeof(buckets));
+  samples = 0;
+  minValue = 0xFFFFFFFFUL;
+  maxValue = 0;
+  sum = 0;
+}
+
+int Histogram::bucketFor(uint32_t value)
+{
+  // Bucket 0 holds 0, bucket n holds [2^(n-1), 2^n).
+  int bucket = 0;
+  while (value != 0 && bucket < BUCKET_COUNT - 1)
+  {
+    value >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+void Histogram::record(uint32_t value)
+{
+  buckets[bucketFor(value)]++;
+  samples++;
+  sum += value;
+  if (value < minValue)
+  {
+    minValue = value;
+  }
+  if (value > maxValue)
+  {
+    maxValue = value;
+  }
+}
+
+uint32_t Histogram::average() const
+{
+  return samples ? (uint32_t)(sum / samples) : 0;
+}
+
+uint32_t Histogram::percentile(int pct) const
+{
+  if (samples == 0)
+  {
+    return 0;
+  }
+
+  pct = constrain(pct, 1, 100);
+  uint32_t rank = (samples * (uint32_t)pct + 99) / 100; // 1-based, rounded up
+  uint32_t seen = 0;
+  for (int i = 0; i < BUCKET_COUNT; i++)
+  {
+    seen += buckets[i];
+    if (seen >= rank)
+    {
+      // Upper edge of bucket i, clamped to what was actually observed.
+      uint32_t upper = (i == 0) ? 0 : ((1UL << i) - 1);
+      return upper > maxValue ? maxValue : upper;
+    }
+  }
+  return maxValue;
+}
+
+String Histogram::toJson() const
+{
+  char buffer[112];
+  snprintf(buffer, sizeof(buffer), "{\"n\":%lu,\"min\":%lu,\"avg\":%lu,\"p95\":%lu,\"p99\":%lu,\"max\":%lu}",
+           (unsigned long)count(), (unsigned long)minimum(), (unsigned long)average(),
+           (unsigned long)percentile(95), (unsigned long)percentile(99), (unsigned long)maximum());
+  return String(buffer);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "Arduino.h"
+
+// Fixed-size histogram for timing metrics. Samples land in power-of-two
+// buckets (0, 1, 2-3, 4-7, ...), so memory stays constant no matter how many
+// samples are recorded. Exact count/min/max/sum are tracked alongside the
+// buckets; percentiles resolve to the upper edge of the matching bucket, which
+// is plenty of precision for spotting a slow path.
+class Histogram
+{
+public:
+  static const int BUCKET_COUNT = 24; // last bucket catches everything >= 2^22
+
+  Histogram();
+
+  void record(uint32_t value);
+  void reset();
+
+  uint32_t count() const { return samples; }
+  uint32_t minimum() const { return samples ? minValue : 0; }
+  uint32_t maximum() const { return maxValue; }
+  uint32_t average() const;
+  uint32_t percentile(int pct) const; // pct in 1-100
+
+  // Compact JSON object: {"n":..,"min":..,"avg":..,"p95":..,"p99":..,"max":..}
+  String toJson() const;
+
+private:
+  uint32_t buckets[BUCKET_COUNT];
+  uint32_t samples;
+  uint32_t minValue;
+  uint32_t maxValue;
+  uint64_t sum;
+
+  static int bucketFor(uint32_t value);
+};
@@ -0,0 +1,110 @@
+#include "LoopProfiler.h"
+#include "CpuFrequency.h"
+
+#ifdef LOOP_PROFILER
+
+LoopProfiler::Frame LoopProfiler::stack[PROFILE_MAX_DEPTH];
+uint8_t LoopProfiler::depth = 0;
+Histogram LoopProfiler::histograms[PROFILE_SECTION_COUNT];
+uint32_t LoopProfiler::longestStallUs = 0;
+ProfileSection LoopProfiler::longestStallSection = PROFILE_OTA;
+
+static const char *const PROFILE_SECTION_NAMES[PROFILE_SECTION_COUNT] = {
+    "ota", "web", "mqtt", "mqtt_reconnect", "wifi", "time", "render", "brightness", "publish",
+    "bg_ota", "bg_web", "bg_mqtt"};
+
+// The cycle counter wraps after 2^32 cycles (~27 s at 160 MHz); anything
+// that long is timed with millis() instead.
+static const unsigned long CYCLE_COUNTER_SAFE_MS = 20000UL;
+
+void LoopProfiler::begin(ProfileSection section)
+{
+  if (depth > 0 && depth <= PROFILE_MAX_DEPTH)
+  {
+    stack[depth - 1].nested = true;
+  }
+  if (depth < PROFILE_MAX_DEPTH)
+  {
+    Frame &frame = stack[depth];
+    frame.section = section;
+    frame.nested = false;
+    frame.startMs = millis();
+    frame.startUs = micros();
+    frame.cpuChanges = CpuFrequency::getChanges();
+    frame.startCycles = ESP.getCycleCount();
+  }
+  depth++;
+}
+
+void LoopProfiler::end()
+{
+  uint32_t endCycles = ESP.getCycleCount();
+  if (depth == 0)
+  {
+    return;
+  }
+  depth--;
+  if (depth >= PROFILE_MAX_DEPTH)
+  {
+    return;
+  }
+
+  // Cycles only convert to time at a single clock frequency; a section that
+  // changed it (CpuBoost) is timed with micros() instead.
+  const Frame &frame = stack[depth];
+  unsigned long elapsedMs = millis() - frame.startMs;
+  uint32_t elapsedUs;
+  if (elapsedMs >= CYCLE_COUNTER_SAFE_MS)
+  {
+    elapsedUs = elapsedMs * 1000UL;
+  }
+  else if (CpuFrequency::getChanges() != frame.cpuChanges)
+  {
+    elapsedUs = micros() - frame.startUs;
+  }
+  else
+  {
+    elapsedUs = (endCycles - frame.startCycles) / CpuFrequency::getMHz();
+  }
+
+  histograms[frame.section].record(elapsedUs);
+  if (!frame.nested && elapsedUs > longestStallUs)
+  {
+    longestStallUs = elapsedUs;
+    longestStallSection = frame.section;
+  }
+}
+
+String LoopProfiler::toJson()
+{
+  String json = "{\"sections\":{";
+  bool first = true;
+  for (int i = 0; i < PROFILE_SECTION_COUNT; i++)
+  {
+    if (histograms[i].count() == 0)
+    {
+      continue;
+    }
+    if (!first)
+    {
+      json += ",";
+    }
+    first = false;
+    json += "\"" + String(PROFILE_SECTION_NAMES[i]) + "\":" + histograms[i].toJson();
+  }
+  json += "},\"stall\":{\"us\":" + String(longestStallUs) + ",\"in\":\"" +
+          String(longestStallUs ? PROFILE_SECTION_NAMES[longestStallSection] : "") + "\"}}";
+  return json;
+}
+
+void LoopProfiler::reset()
+{
+  // Open frames stay on the stack and are recorded into the new window.
+  for (int i = 0; i < PROFILE_SECTION_COUNT; i++)
+  {
+    histograms[i].reset();
+  }
+  longestStallUs = 0;
+}
+
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+#include "Arduino.h"
+
+// Loop timing profiler, built only with -DLOOP_PROFILER (env:d1_mini_profiler).
+// Code marks each call made from the main loop and serviceBackground() with
+// PROFILE_SECTION(PROFILE_WEB) etc. The scope's duration is measured with the
+// CPU cycle counter and recorded in a per-section histogram (in µs). Without
+// LOOP_PROFILER the macro compiles to nothing and none of this is built.
+//
+// Sections nest (serviceBackground() runs inside the MQTT pump while a
+// notification scrolls). Only sections with nothing nested inside them count
+// as stalls, because they held the CPU without servicing the network. The
+// longest stall in the window is reported along with the section it came from.
+
+enum ProfileSection : uint8_t
+{
+  PROFILE_OTA,            // ArduinoOTA + MDNS.update()
+  PROFILE_WEB,            // HTTP server
+  PROFILE_MQTT,           // MQTT pump, including queued notifications
+  PROFILE_MQTT_RECONNECT, // Connect + subscribe + discovery
+  PROFILE_WIFI,           // Wi-Fi connection check
+  PROFILE_TIME,           // Time server sync
+  PROFILE_RENDER,         // Clock redraw
+  PROFILE_BRIGHTNESS,     // Day/night brightness update
+  PROFILE_PUBLISH,        // Periodic status / metrics publish
+  PROFILE_BG_OTA,         // The same services pumped from serviceBackground()
+  PROFILE_BG_WEB,
+  PROFILE_BG_MQTT,
+  PROFILE_SECTION_COUNT
+};
+
+#ifdef LOOP_PROFILER
+#include "Histogram.h"
+
+const uint8_t PROFILE_MAX_DEPTH = 4; // Deeper nesting is measured but not recorded
+
+class LoopProfiler
+{
+public:
+  static void begin(ProfileSection section);
+  static void end();
+
+  // {"sections":{"web":{"n":..,"min":..,"avg":..,"p95":..,"p99":..,"max":..},...},
+  //  "stall":{"us":..,"in":"web"}}; sections with no samples are left out.
+  static String toJson();
+  static void reset(); // Start a new window (called after each MQTT publish)
+
+private:
+  struct Frame
+  {
+    ProfileSection section;
+    uint32_t startCycles;
+    uint32_t startUs;
+    unsigned long startMs;
+    uint32_t cpuChanges; // CpuFrequency::getChanges() at the start
+    bool nested; // Another section ran inside this one
+  };
+
+  static Frame stack[PROFILE_MAX_DEPTH];
+  static uint8_t depth;
+  static Histogram histograms[PROFILE_SECTION_COUNT];
+  static uint32_t longestStallUs;
+  static ProfileSection longestStallSection;
+};
+
+class ProfileScope
+{
+public:
+  explicit ProfileScope(ProfileSection section) { LoopProfiler::begin(section); }
+  ~ProfileScope() { LoopProfiler::end(); }
+};
+#define PROFILE_SECTION(section) ProfileScope profileScope_(section)
+#else
+#define PROFILE_SECTION(section) \
+  do                             \
+  {                              \
+  } while (0)
+#endif
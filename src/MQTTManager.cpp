@@ -1,6 +1,13 @@
 #include "MQTTManager.h"
 #include "Settings.h"
 #include "BackgroundService.h"
+#include "HeapMonitor.h"
+#include "LoopProfiler.h"
+#include "StallMonitor.h"
+#include "PowerManager.h"
+#include "CpuFrequency.h"
+#include "FramePacer.h"
+#include "BootTimeline.h"
 #include <TimeLib.h>
 
 // Static member initialization
@@ -10,14 +17,18 @@ MQTTManager::MQTTManager(DisplayManager &displayRef, TimeManager &timeRef)
     : display(displayRef), timeManager(timeRef), mqttClient(wifiClient),
       dayBrightness(DEFAULT_DAY_BRIGHTNESS), nightBrightness(DEFAULT_NIGHT_BRIGHTNESS),
       dayStartMinutes(DEFAULT_DAY_START_MINUTES), nightStartMinutes(DEFAULT_NIGHT_START_MINUTES),
-      showingNotification(false), lastReconnectAttempt(0), reconnectAttempts(0),
-      lastStatusPublish(0), filesystemAvailable(false)
+      showingNotification(false), lastMessageReceivedMs(0), droppedCommands(0),
+      reconnectAttempts(0), bootReportPublished(false), filesystemAvailable(false),
+      persisted(), persistedValid(false), settingsDirty(false), lastSettingsChange(0), settingsWrites(0)
 {
   instance = this; // Set static reference for callback
 }
 
 void MQTTManager::initialize()
 {
+  // Settings come straight from flash, no filesystem mount needed.
+  bool settingsLoaded = loadSettings();
+
   // Initialize LittleFS with retry
   for (int attempt = 0; attempt < 3; attempt++)
   {
@@ -25,7 +36,10 @@ void MQTTManager::initialize()
     {
       filesystemAvailable = true;
       Serial.println("LittleFS initialized successfully");
-      loadSettings();
+      if (!settingsLoaded)
+      {
+        migrateLegacySettings();
+      }
       break;
     }
     Serial.print("LittleFS initialization attempt ");
@@ -36,53 +50,49 @@ void MQTTManager::initialize()
 
   if (!filesystemAvailable)
   {
-    Serial.println("LittleFS initialization failed after 3 attempts! Using defaults.");
-    Serial.println("Settings will not be persisted.");
+    Serial.println("LittleFS initialization failed after 3 attempts!");
+    Serial.println("Long chunked notifications will be kept in RAM only.");
   }
 
+  // Long chunked texts live in RAM, or in LittleFS when it is available.
+  textStore.begin(filesystemAvailable);
+
   // Cap how long the underlying TCP connect can block so a missing or
   // unreachable broker (e.g. an unresolved "homeassistant" hostname)
   // cannot stall the main loop.
   wifiClient.setTimeout(MQTT_CONNECT_TIMEOUT_MS);
 
-  mqttClient.setServer(MQTT_SERVER.c_str(), MQTT_PORT);
+  mqttClient.setServer(MQTT_SERVER, MQTT_PORT);
   mqttClient.setCallback(mqttCallback);
   mqttClient.setBufferSize(MQTT_BUFFER_SIZE);
   mqttClient.setSocketTimeout(MQTT_SOCKET_TIMEOUT_S); // cap MQTT handshake/read wait
 
   Serial.println("MQTT Manager initialized");
 
-  // Do NOT connect here. Connecting is handled lazily and rate-limited in
-  // loop() -> tryReconnect(), so setup() never blocks on an unreachable
-  // broker and OTA/Web/clock always come up.
+  // Do NOT connect here. Connecting is handled lazily by the scheduler's
+  // reconnect task (every MQTT_RECONNECT_INTERVAL), so setup() never blocks
+  // on an unreachable broker and OTA/Web/clock always come up.
 }
 
 void MQTTManager::loop()
 {
-  if (!mqttClient.connected())
-  {
-    tryReconnect();
-  }
+  // Reconnecting, brightness, status and metrics run as their own scheduler
+  // tasks (see main.cpp); this is the frequent pump.
   mqttClient.loop();
 
-  // Process notification queue if not currently showing a notification
-  if (!showingNotification)
-  {
-    processNotificationQueue();
-  }
+  // Apply settings commands that were held back by the rate limiter.
+  applyPendingCommands();
 
-  // Update brightness based on current time (only if not showing notification)
-  if (!showingNotification)
+  // Persist settings once they have stopped changing.
+  if (settingsDirty && millis() - lastSettingsChange >= SETTINGS_SAVE_DEBOUNCE_MS)
   {
-    updateBrightnessBasedOnTime();
+    saveSettings();
   }
 
-  // Periodically refresh status so HA sensors (Day/Night mode, etc.) stay
-  // current as the clock crosses a schedule boundary, even with no commands.
-  if (mqttClient.connected() &&
-      (millis() - lastStatusPublish >= MQTT_STATUS_PUBLISH_INTERVAL))
+  // Process notification queue if not currently showing a notification
+  if (!showingNotification)
   {
-    sendStatus("online");
+    processNotificationQueue();
   }
 }
 
@@ -106,36 +116,30 @@ bool MQTTManager::tryReconnect()
     return true;
   }
 
-  // Check if enough time has passed since last attempt
-  unsigned long now = millis();
-  if (now - lastReconnectAttempt < MQTT_RECONNECT_INTERVAL)
-  {
-    return false;
-  }
-
-  lastReconnectAttempt = now;
   reconnectAttempts++;
 
   Serial.print("Attempting MQTT connection (attempt ");
   Serial.print(reconnectAttempts);
   Serial.print(")...");
 
-  String clientId = MQTT_CLIENT_ID + "-" + String(random(0xffff), HEX);
+  String clientId = String(MQTT_CLIENT_ID) + "-" + String(random(0xffff), HEX);
 
   // When no username is configured, connect anonymously: we must NOT send
   // credentials at all. Sending an empty/incorrect username makes a broker
   // that allows anonymous access reject us with "not authorised".
-  const String willMessage = "{\"status\":\"offline\"}";
+  const char *willMessage = "{\"status\":\"offline\"}";
+  char willTopic[MQTT_TOPIC_BUFFER_SIZE];
+  mqttTopicCopy(TOPIC_STATUS, willTopic);
   bool connected;
-  if (MQTT_USER.length() == 0)
+  if (MQTT_USER[0] == '\0')
   {
     connected = mqttClient.connect(clientId.c_str(),
-                                   MQTT_TOPIC_STATUS.c_str(), 0, true, willMessage.c_str());
+                                   willTopic, 0, true, willMessage);
   }
   else
   {
-    connected = mqttClient.connect(clientId.c_str(), MQTT_USER.c_str(), MQTT_PASSWORD.c_str(),
-                                   MQTT_TOPIC_STATUS.c_str(), 0, true, willMessage.c_str());
+    connected = mqttClient.connect(clientId.c_str(), MQTT_USER, MQTT_PASSWORD,
+                                   willTopic, 0, true, willMessage);
   }
 
   if (connected)
@@ -143,19 +147,30 @@ bool MQTTManager::tryReconnect()
     Serial.println(" connected!");
     reconnectAttempts = 0;
 
-    // Subscribe to topics
-    mqttClient.subscribe(MQTT_TOPIC_NOTIFICATION.c_str());
-    mqttClient.subscribe(MQTT_TOPIC_ANIMATION.c_str());
-    mqttClient.subscribe(MQTT_TOPIC_BRIGHTNESS_DAY.c_str());
-    mqttClient.subscribe(MQTT_TOPIC_BRIGHTNESS_NIGHT.c_str());
-    mqttClient.subscribe(MQTT_TOPIC_SCHEDULE_DAY_START.c_str());
-    mqttClient.subscribe(MQTT_TOPIC_SCHEDULE_NIGHT_START.c_str());
-    mqttClient.subscribe((MQTT_TOPIC_PREFIX + "/discovery").c_str());
+    // Subscribe to every command topic in the table
+    char topic[MQTT_TOPIC_BUFFER_SIZE];
+    for (uint8_t i = 0; i < TOPIC_COUNT; i++)
+    {
+      if (mqttTopicIsCommand((MqttTopic)i))
+      {
+        mqttClient.subscribe(mqttTopicCopy((MqttTopic)i, topic));
+      }
+    }
 
     // Send discovery config and status
     sendDiscoveryConfig();
     sendStatus("online");
 
+    // Once per boot: why the previous boot ended, how close it came to the
+    // watchdog, and how long this boot took (retained, so they are still
+    // there after HA restarts).
+    BootTimeline::mark(BOOT_MQTT_CONNECTED);
+    if (!bootReportPublished)
+    {
+      bootReportPublished = publish(TOPIC_DIAGNOSTICS, StallMonitor::bootReportJson().c_str(), true) &&
+                            publish(TOPIC_BOOT, BootTimeline::toJson().c_str(), true);
+    }
+
     Serial.println("Subscribed to MQTT topics");
     return true;
   }
@@ -171,6 +186,12 @@ bool MQTTManager::isConnected()
   return mqttClient.connected();
 }
 
+bool MQTTManager::publish(MqttTopic topic, const char *payload, bool retained)
+{
+  char topicBuffer[MQTT_TOPIC_BUFFER_SIZE];
+  return mqttClient.publish(mqttTopicCopy(topic, topicBuffer), payload, retained);
+}
+
 void MQTTManager::sendStatus(const String &status)
 {
   if (mqttClient.connected())
@@ -181,11 +202,12 @@ void MQTTManager::sendStatus(const String &status)
     payload += "\"night_brightness\":" + String(nightBrightness) + ",";
     payload += "\"day_start\":\"" + minutesToTimeString(dayStartMinutes) + "\",";
     payload += "\"night_start\":\"" + minutesToTimeString(nightStartMinutes) + "\",";
-    payload += "\"is_day_time\":" + String(isDayTime() ? "true" : "false");
+    payload += "\"is_day_time\":" + String(isDayTime() ? "true" : "false") + ",";
+    payload += "\"dropped_commands\":" + String(droppedCommands) + ",";
+    payload += "\"settings_writes\":" + String(settingsWrites);
     payload += "}";
 
-    mqttClient.publish(MQTT_TOPIC_STATUS.c_str(), payload.c_str(), true); // Retained status
-    lastStatusPublish = millis();
+    publish(TOPIC_STATUS, payload.c_str(), true); // Retained status
   }
 }
 
@@ -215,10 +237,15 @@ void MQTTManager::publishDiscovery(const String &component, const String &object
     return;
   }
   String payload = "{" + fields + "," + buildDeviceInfo() + "}";
-  String topic = "homeassistant/" + component + "/mqtt_clock/" + objectId + "/config";
+  String topic = discoveryTopic(component, objectId);
   mqttClient.publish(topic.c_str(), payload.c_str(), true);
 }
 
+String MQTTManager::discoveryTopic(const String &component, const String &objectId)
+{
+  return "homeassistant/" + component + "/mqtt_clock/" + objectId + "/config";
+}
+
 void MQTTManager::sendDiscoveryConfig()
 {
   if (!mqttClient.connected())
@@ -234,7 +261,7 @@ void MQTTManager::sendDiscoveryConfig()
                    "\"unique_id\":\"" +
                        id + "_status\","
                             "\"state_topic\":\"" +
-                       MQTT_TOPIC_STATUS + "\","
+                       mqttTopic(TOPIC_STATUS) + "\","
                                            "\"value_template\":\"{{ value_json.status }}\","
                                            "\"icon\":\"mdi:clock-digital\"");
 
@@ -244,7 +271,7 @@ void MQTTManager::sendDiscoveryConfig()
                    "\"unique_id\":\"" +
                        id + "_daynight\","
                             "\"state_topic\":\"" +
-                       MQTT_TOPIC_STATUS + "\","
+                       mqttTopic(TOPIC_STATUS) + "\","
                                            "\"value_template\":\"{% if value_json.is_day_time %}Day{% else %}Night{% endif %}\","
                                            "\"icon\":\"mdi:weather-sunny\"");
 
@@ -254,9 +281,9 @@ void MQTTManager::sendDiscoveryConfig()
                    "\"unique_id\":\"" +
                        id + "_day_brightness\","
                             "\"state_topic\":\"" +
-                       MQTT_TOPIC_STATUS + "\","
+                       mqttTopic(TOPIC_STATUS) + "\","
                                            "\"command_topic\":\"" +
-                       MQTT_TOPIC_BRIGHTNESS_DAY + "\","
+                       mqttTopic(TOPIC_BRIGHTNESS_DAY) + "\","
                                                    "\"value_template\":\"{{ value_json.day_brightness }}\","
                                                    "\"min\":0,\"max\":15,\"step\":1,"
                                                    "\"icon\":\"mdi:brightness-6\"");
@@ -267,9 +294,9 @@ void MQTTManager::sendDiscoveryConfig()
                    "\"unique_id\":\"" +
                        id + "_night_brightness\","
                             "\"state_topic\":\"" +
-                       MQTT_TOPIC_STATUS + "\","
+                       mqttTopic(TOPIC_STATUS) + "\","
                                            "\"command_topic\":\"" +
-                       MQTT_TOPIC_BRIGHTNESS_NIGHT + "\","
+                       mqttTopic(TOPIC_BRIGHTNESS_NIGHT) + "\","
                                                      "\"value_template\":\"{{ value_json.night_brightness }}\","
                                                      "\"min\":0,\"max\":15,\"step\":1,"
                                                      "\"icon\":\"mdi:brightness-3\"");
@@ -281,24 +308,17 @@ void MQTTManager::sendDiscoveryConfig()
                    "\"unique_id\":\"" +
                        id + "_notification\","
                             "\"command_topic\":\"" +
-                       MQTT_TOPIC_NOTIFICATION + "\","
+                       mqttTopic(TOPIC_NOTIFICATION) + "\","
                                                  "\"json_attributes_topic\":\"" +
-                       MQTT_TOPIC_NOTIFICATION_HELP + "\","
+                       mqttTopic(TOPIC_NOTIFICATION_HELP) + "\","
                                                       "\"icon\":\"mdi:message-text\"");
 
   // Publish the usage docs (retained) so they appear under the notification
   // entity's Attributes in Home Assistant.
   publishNotificationHelp();
 
-  // 6. Animation Select (dropdown: heart / wave / pulse)
-  publishDiscovery("select", "animation",
-                   "\"name\":\"Animation\","
-                   "\"unique_id\":\"" +
-                       id + "_animation\","
-                            "\"command_topic\":\"" +
-                       MQTT_TOPIC_ANIMATION + "\","
-                                              "\"options\":[\"heart\",\"wave\",\"pulse\"],"
-                                              "\"icon\":\"mdi:animation-play\"");
+  // 6. Animation Select (built-ins plus the animations uploaded so far)
+  publishAnimationSelect();
 
   // Remove the previous hour-only "number" entities (superseded by the time
   // entities below). Publishing an empty retained payload deletes a stale
@@ -312,9 +332,9 @@ void MQTTManager::sendDiscoveryConfig()
                    "\"unique_id\":\"" +
                        id + "_day_start_time\","
                             "\"state_topic\":\"" +
-                       MQTT_TOPIC_STATUS + "\","
+                       mqttTopic(TOPIC_STATUS) + "\","
                                            "\"command_topic\":\"" +
-                       MQTT_TOPIC_SCHEDULE_DAY_START + "\","
+                       mqttTopic(TOPIC_SCHEDULE_DAY_START) + "\","
                                                       "\"value_template\":\"{{ value_json.day_start }}\","
                                                       "\"icon\":\"mdi:weather-sunset-up\"");
 
@@ -324,9 +344,9 @@ void MQTTManager::sendDiscoveryConfig()
                    "\"unique_id\":\"" +
                        id + "_night_start_time\","
                             "\"state_topic\":\"" +
-                       MQTT_TOPIC_STATUS + "\","
+                       mqttTopic(TOPIC_STATUS) + "\","
                                            "\"command_topic\":\"" +
-                       MQTT_TOPIC_SCHEDULE_NIGHT_START + "\","
+                       mqttTopic(TOPIC_SCHEDULE_NIGHT_START) + "\","
                                                         "\"value_template\":\"{{ value_json.night_start }}\","
                                                         "\"icon\":\"mdi:weather-sunset-down\"");
 }
@@ -340,43 +360,136 @@ void MQTTManager::publishNotificationHelp()
 
   // Each key becomes an attribute on the "Send Notification" entity in HA.
   // Keep this compact so the whole packet stays within MQTT_BUFFER_SIZE.
-  String help = "{"
-                "\"usage\":\"Publish plain text (scrolls once) or a JSON object\","
+  String help = String("{"
+                "\"usage\":\"Publish plain text (scrolls once), a JSON object or a JSON array of them\","
                 "\"message\":\"string, required\","
                 "\"scrolling\":\"bool, default true; false = static/centered\","
                 "\"speed\":\"int 5-100 ms, default 35; lower = faster\","
+                "\"pps\":\"number 1-400 px/s; overrides speed\","
+                "\"ease\":\"bool; speed up at the start, slow down at the end\","
+                "\"clock\":\"bool; scroll beside a compact clock\","
                 "\"repeat\":\"int 1-10, default 1\","
                 "\"brightness\":\"int 0-15 or -1, default -1 (keep current)\","
                 "\"duration\":\"int 1-30 s, default 3; static hold time\","
                 "\"flash\":\"bool, default false; quick fade out/in before holding (static only)\","
                 "\"flash_count\":\"int 1-10, default 2; number of fade pulses\","
+                "\"batch\":\"[{..},{..}] queues a group; {\\\"playlist\\\":true,\\\"notifications\\\":[..]} plays it without the clock in between\","
                 "\"example\":\"{\\\"message\\\":\\\"Dinner!\\\",\\\"scrolling\\\":false,\\\"flash\\\":true}\","
-                "\"animation\":\"publish heart|wave|pulse to " +
-                MQTT_TOPIC_ANIMATION + "\""
-                                       "}";
+                "\"animation\":\"publish heart|wave|pulse or the name of an uploaded animation to ") +
+                mqttTopic(TOPIC_ANIMATION) + "\""
+                                             "}";
+
+  publish(TOPIC_NOTIFICATION_HELP, help.c_str(), true);
+}
+
+void MQTTManager::publishAnimationSelect()
+{
+  if (!mqttClient.connected())
+  {
+    return;
+  }
+
+  String head = "\"name\":\"Animation\","
+                "\"unique_id\":\"" +
+                getDeviceId() + "_animation\","
+                                "\"command_topic\":\"" +
+                mqttTopic(TOPIC_ANIMATION) + "\","
+                                           "\"options\":";
+  String tail = ",\"icon\":\"mdi:animation-play\"";
+
+  // The options get what is left of MQTT_BUFFER_SIZE after the packet
+  // header, the topic, the other fields and the device block. Uploads that
+  // do not fit are left out of the select but still play by name.
+  size_t used = MQTT_MAX_HEADER_SIZE + 2 + discoveryTopic("select", "animation").length() +
+                head.length() + tail.length() + buildDeviceInfo().length() + 3; // Braces and comma
+  size_t budget = (size_t)MQTT_BUFFER_SIZE;
+  String options = AnimationPlayer::namesJson(used < budget ? budget - used : 0);
+  publishDiscovery("select", "animation", head + options + tail);
+}
+
+void MQTTManager::sendMetrics()
+{
+  if (!mqttClient.connected())
+  {
+    return;
+  }
+
+  String payload = "{";
+  payload += "\"window_s\":" + String(MQTT_METRICS_PUBLISH_INTERVAL / 1000UL) + ",";
+  payload += "\"heap\":" + HeapMonitor::toJson() + ",";
+  payload += "\"near_misses\":" + String(StallMonitor::getNearMisses()) + ",";
+  payload += "\"power\":" + PowerManager::toJson() + ",";
+  payload += "\"cpu\":" + CpuFrequency::toJson();
+  if (FramePacer::hasFrames())
+  {
+    payload += ",\"frames\":" + FramePacer::toJson();
+  }
+
+  // Notification latency only when something was shown this window.
+  if (displayDuration.count() > 0)
+  {
+    payload += ",\"queue_depth\":" + String(notificationQueue.size()) + ",";
+    payload += "\"ingest_ms\":" + ingestLatency.toJson() + ",";
+    payload += "\"queue_wait_ms\":" + queueWaitLatency.toJson() + ",";
+    payload += "\"display_ms\":" + displayDuration.toJson();
+  }
+  payload += "}";
+
+  publish(TOPIC_METRICS, payload.c_str());
+
+  ingestLatency.reset();
+  queueWaitLatency.reset();
+  displayDuration.reset();
+  PowerManager::reset();
+  CpuFrequency::reset();
+  FramePacer::reset();
+
+#ifdef LOOP_PROFILER
+  // Separate message: a full profile would not fit next to the above in
+  // MQTT_BUFFER_SIZE.
+  publish(TOPIC_METRICS_LOOP, LoopProfiler::toJson().c_str());
+  LoopProfiler::reset();
+#endif
+}
+
+void MQTTManager::recordNotificationLatency(const NotificationConfig &config)
+{
+  if (config.enqueuedMs == 0 || config.displayStartMs == 0)
+  {
+    return; // Not a queued notification (e.g. shown directly on a parse error)
+  }
+
+  ingestLatency.record(config.enqueuedMs - config.receivedMs);
+  queueWaitLatency.record(config.displayStartMs - config.enqueuedMs);
+  displayDuration.record(config.displayEndMs - config.displayStartMs);
 
-  mqttClient.publish(MQTT_TOPIC_NOTIFICATION_HELP.c_str(), help.c_str(), true);
+  Serial.println("Notification latency: ingest " + String(config.enqueuedMs - config.receivedMs) +
+                 " ms, queued " + String(config.displayStartMs - config.enqueuedMs) +
+                 " ms, shown " + String(config.displayEndMs - config.displayStartMs) + " ms");
 }
 
 void MQTTManager::mqttCallback(char *topic, byte *payload, unsigned int length)
 {
   if (instance)
   {
+    instance->lastMessageReceivedMs = millis();
     String message = "";
+    message.reserve(length);
     for (unsigned int i = 0; i < length; i++)
     {
       message += (char)payload[i];
     }
-    instance->handleMessage(String(topic), message);
+    instance->handleMessage(mqttTopicFind(topic), message);
   }
 }
 
-void MQTTManager::handleMessage(const String &topic, const String &message)
+void MQTTManager::handleMessage(MqttTopic topic, const String &message)
 {
-  if (topic == MQTT_TOPIC_NOTIFICATION)
+  switch (topic)
   {
-    // Check if message is JSON (starts with '{')
-    if (message.startsWith("{"))
+  case TOPIC_NOTIFICATION:
+    // Check if message is JSON: a single object ('{') or a batch array ('[')
+    if (message.startsWith("{") || message.startsWith("["))
     {
       parseNotificationJson(message);
     }
@@ -385,54 +498,121 @@ void MQTTManager::handleMessage(const String &topic, const String &message)
       // Queue simple string message
       NotificationConfig config;
       config.message = message;
+      config.receivedMs = lastMessageReceivedMs;
       config.isSimpleMessage = true;
       config.isScrolling = true; // Simple messages always scroll
       queueNotification(config);
     }
-  }
-  else if (topic == MQTT_TOPIC_BRIGHTNESS_DAY)
+    break;
+
+  case TOPIC_NOTIFICATION_CHUNK:
+    handleNotificationChunk(message);
+    break;
+
+  case TOPIC_BRIGHTNESS_DAY:
+  case TOPIC_BRIGHTNESS_NIGHT:
   {
     int brightness = message.toInt();
-    if (brightness >= 0 && brightness <= 15)
+    SettingsCommand command = (topic == TOPIC_BRIGHTNESS_DAY) ? CMD_DAY_BRIGHTNESS : CMD_NIGHT_BRIGHTNESS;
+    if (brightness < 0 || brightness > 15 || !submitCommand(command, brightness))
     {
-      setDayBrightness(brightness);
+      return; // Invalid, or deferred by the rate limiter (status goes out when applied)
     }
+    break;
   }
-  else if (topic == MQTT_TOPIC_BRIGHTNESS_NIGHT)
+
+  case TOPIC_SCHEDULE_DAY_START:
+  case TOPIC_SCHEDULE_NIGHT_START:
   {
-    int brightness = message.toInt();
-    if (brightness >= 0 && brightness <= 15)
+    int minutes = parseTimeStringToMinutes(message);
+    SettingsCommand command = (topic == TOPIC_SCHEDULE_DAY_START) ? CMD_DAY_START : CMD_NIGHT_START;
+    if (minutes < 0 || !submitCommand(command, minutes))
     {
-      setNightBrightness(brightness);
+      return;
     }
+    break;
   }
-  else if (topic == MQTT_TOPIC_SCHEDULE_DAY_START)
-  {
-    int minutes = parseTimeStringToMinutes(message);
-    if (minutes >= 0)
+
+  case TOPIC_DISCOVERY:
+    if (!discoveryBucket.tryTake())
     {
-      setDayStartMinutes(minutes);
+      droppedCommands++;
+      return; // Discovery was re-sent moments ago
     }
+    sendDiscoveryConfig();
+    break;
+
+  case TOPIC_ANIMATION:
+    playAnimation(message);
+    break;
+
+  default:
+    return; // Not one of our command topics
   }
-  else if (topic == MQTT_TOPIC_SCHEDULE_NIGHT_START)
+
+  // Send updated status
+  sendStatus("online");
+}
+
+bool MQTTManager::submitCommand(SettingsCommand command, int value)
+{
+  RateLimitedCommand &slot = commands[command];
+  if (!slot.pending && slot.bucket.tryTake())
   {
-    int minutes = parseTimeStringToMinutes(message);
-    if (minutes >= 0)
+    applyCommand(command, value);
+    return true;
+  }
+
+  // Over the limit: keep only the latest value. One that was already waiting
+  // is superseded and never applied.
+  if (slot.pending)
+  {
+    droppedCommands++;
+  }
+  slot.pending = true;
+  slot.value = value;
+  return false;
+}
+
+void MQTTManager::applyPendingCommands()
+{
+  bool applied = false;
+  for (int i = 0; i < CMD_COUNT; i++)
+  {
+    RateLimitedCommand &slot = commands[i];
+    if (slot.pending && slot.bucket.tryTake())
     {
-      setNightStartMinutes(minutes);
+      slot.pending = false;
+      applyCommand((SettingsCommand)i, slot.value);
+      applied = true;
     }
   }
-  else if (topic == MQTT_TOPIC_PREFIX + "/discovery")
+
+  if (applied)
   {
-    sendDiscoveryConfig();
+    sendStatus("online");
   }
-  else if (topic == MQTT_TOPIC_ANIMATION)
+}
+
+void MQTTManager::applyCommand(SettingsCommand command, int value)
+{
+  switch (command)
   {
-    playAnimation(message);
+  case CMD_DAY_BRIGHTNESS:
+    setDayBrightness(value);
+    break;
+  case CMD_NIGHT_BRIGHTNESS:
+    setNightBrightness(value);
+    break;
+  case CMD_DAY_START:
+    setDayStartMinutes(value);
+    break;
+  case CMD_NIGHT_START:
+    setNightStartMinutes(value);
+    break;
+  default:
+    break;
   }
-
-  // Send updated status
-  sendStatus("online");
 }
 
 void MQTTManager::showNotification(const String &message)
@@ -450,28 +630,42 @@ void MQTTManager::setDayBrightness(int brightness)
 {
   dayBrightness = constrain(brightness, 0, 15);
   updateBrightnessBasedOnTime();
-  saveSettings();
+  markSettingsDirty();
 }
 
 void MQTTManager::setNightBrightness(int brightness)
 {
   nightBrightness = constrain(brightness, 0, 15);
   updateBrightnessBasedOnTime();
-  saveSettings();
+  markSettingsDirty();
 }
 
 void MQTTManager::setDayStartMinutes(int minutes)
 {
   dayStartMinutes = constrain(minutes, 0, 1439);
   updateBrightnessBasedOnTime();
-  saveSettings();
+  markSettingsDirty();
 }
 
 void MQTTManager::setNightStartMinutes(int minutes)
 {
   nightStartMinutes = constrain(minutes, 0, 1439);
   updateBrightnessBasedOnTime();
-  saveSettings();
+  markSettingsDirty();
+}
+
+void MQTTManager::markSettingsDirty()
+{
+  settingsDirty = true;
+  lastSettingsChange = millis();
+}
+
+void MQTTManager::flushSettings()
+{
+  if (settingsDirty)
+  {
+    saveSettings();
+  }
 }
 
 String MQTTManager::minutesToTimeString(int minutes)
@@ -510,7 +704,7 @@ int MQTTManager::currentAutoBrightness()
   // Before the first successful time sync, hour()/minute() read 00:00, which
   // would wrongly select night mode and blank the display. Until we actually
   // know the time, use the (brighter, always-visible) day brightness.
-  if (!timeManager.isTimeSynced())
+  if (!timeManager.hasTime())
   {
     return dayBrightness;
   }
@@ -519,7 +713,9 @@ int MQTTManager::currentAutoBrightness()
 
 void MQTTManager::updateBrightnessBasedOnTime()
 {
-  display.setIntensity(currentAutoBrightness());
+  // Cross-fade rather than jump at the day/night boundary and on settings
+  // changes. Called every second; a no-op while the target is unchanged.
+  display.fadeIntensityTo(currentAutoBrightness(), BRIGHTNESS_CROSSFADE_MS);
 }
 
 bool MQTTManager::isDayTime()
@@ -538,7 +734,41 @@ bool MQTTManager::isDayTime()
   }
 }
 
-void MQTTManager::loadSettings()
+ClockSettings MQTTManager::currentSettings() const
+{
+  ClockSettings settings;
+  settings.dayBrightness = dayBrightness;
+  settings.nightBrightness = nightBrightness;
+  settings.dayStartMinutes = dayStartMinutes;
+  settings.nightStartMinutes = nightStartMinutes;
+  return settings;
+}
+
+void MQTTManager::applySettings(const ClockSettings &settings)
+{
+  dayBrightness = constrain(settings.dayBrightness, 0, 15);
+  nightBrightness = constrain(settings.nightBrightness, 0, 15);
+  dayStartMinutes = constrain(settings.dayStartMinutes, 0, 1439);
+  nightStartMinutes = constrain(settings.nightStartMinutes, 0, 1439);
+}
+
+bool MQTTManager::loadSettings()
+{
+  ClockSettings settings;
+  if (!settingsStore.load(settings))
+  {
+    Serial.println("No stored settings found");
+    return false;
+  }
+
+  applySettings(settings);
+  persisted = currentSettings();
+  persistedValid = true;
+  Serial.println("Settings loaded");
+  return true;
+}
+
+void MQTTManager::migrateLegacySettings()
 {
   File file = LittleFS.open("/clock_settings.json", "r");
   if (!file)
@@ -557,70 +787,77 @@ void MQTTManager::loadSettings()
     return;
   }
 
+  ClockSettings settings;
+
   // Load settings with defaults if not found
-  dayBrightness = doc["day_brightness"] | DEFAULT_DAY_BRIGHTNESS;
-  nightBrightness = doc["night_brightness"] | DEFAULT_NIGHT_BRIGHTNESS;
+  settings.dayBrightness = doc["day_brightness"] | DEFAULT_DAY_BRIGHTNESS;
+  settings.nightBrightness = doc["night_brightness"] | DEFAULT_NIGHT_BRIGHTNESS;
 
   // Prefer the new minute-based keys. Fall back to the legacy hour-only keys
   // (from firmware before HH:MM support) so existing devices keep their schedule.
   if (doc["day_start_minutes"].is<int>())
   {
-    dayStartMinutes = doc["day_start_minutes"];
+    settings.dayStartMinutes = doc["day_start_minutes"];
   }
   else
   {
-    dayStartMinutes = (doc["day_start_hour"] | (DEFAULT_DAY_START_MINUTES / 60)) * 60;
+    settings.dayStartMinutes = (doc["day_start_hour"] | (DEFAULT_DAY_START_MINUTES / 60)) * 60;
   }
 
   if (doc["night_start_minutes"].is<int>())
   {
-    nightStartMinutes = doc["night_start_minutes"];
+    settings.nightStartMinutes = doc["night_start_minutes"];
   }
   else
   {
-    nightStartMinutes = (doc["night_start_hour"] | (DEFAULT_NIGHT_START_MINUTES / 60)) * 60;
+    settings.nightStartMinutes = (doc["night_start_hour"] | (DEFAULT_NIGHT_START_MINUTES / 60)) * 60;
   }
 
-  dayStartMinutes = constrain(dayStartMinutes, 0, 1439);
-  nightStartMinutes = constrain(nightStartMinutes, 0, 1439);
+  applySettings(settings);
+
+  // Move the settings into the binary store right away; the JSON file is
+  // only removed once that write has succeeded.
+  saveSettings();
+  if (persistedValid && persisted == currentSettings())
+  {
+    LittleFS.remove("/clock_settings.json");
+    Serial.println("Migrated settings from /clock_settings.json");
+  }
 }
 
 void MQTTManager::saveSettings()
 {
-  if (!filesystemAvailable)
+  STALL_SECTION(STALL_SETTINGS_SAVE);
+
+  // Skip the flash write when the store already holds these values (e.g. a
+  // slider dragged away and back again).
+  ClockSettings settings = currentSettings();
+  if (persistedValid && persisted == settings)
   {
-    Serial.println("Filesystem not available, cannot save settings");
+    settingsDirty = false;
     return;
   }
 
-  JsonDocument doc;
-
-  doc["day_brightness"] = dayBrightness;
-  doc["night_brightness"] = nightBrightness;
-  doc["day_start_minutes"] = dayStartMinutes;
-  doc["night_start_minutes"] = nightStartMinutes;
-
-  File file = LittleFS.open("/clock_settings.json", "w");
-  if (!file)
+  if (!settingsStore.save(settings))
   {
-    Serial.println("Failed to open settings file for writing");
+    // Keep the change and try again after another debounce period.
+    Serial.println("Failed to write settings to flash, will retry");
+    markSettingsDirty();
     return;
   }
 
-  if (serializeJson(doc, file) == 0)
-  {
-    Serial.println("Failed to write settings to file");
-  }
-  else
-  {
-    Serial.println("Settings saved successfully");
-  }
+  settingsDirty = false;
 
-  file.close();
+  Serial.println("Settings saved successfully");
+  settingsWrites++;
+  persisted = settings;
+  persistedValid = true;
 }
 
 void MQTTManager::showAdvancedNotification(const NotificationConfig &config)
 {
+  STALL_SECTION(STALL_NOTIFICATION);
+  HEAP_AUDIT_SCOPE(HEAP_DISPLAY); // Rendering, though reached from the MQTT loop
   currentConfig = config;
   currentNotification = config.message;
   showingNotification = true;
@@ -635,10 +872,20 @@ void MQTTManager::showAdvancedNotification(const NotificationConfig &config)
 
   if (config.isScrolling)
   {
+    ScrollStyle style = {config.scrollVelocity, config.scrollEased ? SCROLL_EASED : SCROLL_CONSTANT, config.showClock};
+
     // Perform scrolling repeats
     for (int i = 0; i < config.scrollRepeat; i++)
     {
-      display.scrollMessage(config.message, config.scrollSpeed);
+      if (config.textSlot >= 0)
+      {
+        StoredText text(textStore, config.textSlot);
+        display.scrollText(text, style);
+      }
+      else
+      {
+        display.scrollMessage(config.message, style);
+      }
       if (i < config.scrollRepeat - 1)
         serviceDelay(500); // Brief pause between repeats
     }
@@ -652,23 +899,25 @@ void MQTTManager::showAdvancedNotification(const NotificationConfig &config)
     int holdBrightness = (config.brightness >= 0) ? config.brightness : currentAutoBrightness();
 
     // Draw the message once; the fade only modulates panel intensity, so the
-    // text stays on screen throughout.
+    // text stays on screen throughout. It dissolves in over what was shown.
+    display.transitionNext(TRANSITION_DISSOLVE);
     display.fillScreen(LOW);
     display.centerPrint(config.message);
     display.setIntensity(holdBrightness);
 
     // Optionally fade the message out and back in a few times to grab
-    // attention, then hold it steady for the configured duration.
+    // attention, then hold it steady for the configured duration. The pulses
+    // run on the brightness animator; we only wait for them here.
     if (config.flashEffect)
     {
       for (int i = 0; i < config.flashCount; i++)
       {
         display.fadeMessage(holdBrightness, NOTIFICATION_FADE_STEP_MS);
+        serviceDelay(display.brightnessAnimationRemainingMs());
       }
     }
 
     // Hold the message steady at the set brightness.
-    display.setIntensity(holdBrightness);
     serviceDelay((unsigned long)config.holdSeconds * 1000UL);
 
     // Static notification is done, return to clock
@@ -689,27 +938,132 @@ void MQTTManager::parseNotificationJson(const String &jsonString)
     return;
   }
 
+  // Batch forms, parsed in the same pass:
+  //   [ {...}, "text", ... ]                       -> queued back to back
+  //   {"playlist": true, "notifications": [ ... ]} -> shown as one playlist
+  if (doc.is<JsonArrayConst>())
+  {
+    queueNotificationBatch(doc.as<JsonArrayConst>(), false);
+    return;
+  }
+  if (doc["notifications"].is<JsonArrayConst>())
+  {
+    queueNotificationBatch(doc["notifications"].as<JsonArrayConst>(), doc["playlist"] | false);
+    return;
+  }
+
   NotificationConfig config;
+  configFromJson(doc.as<JsonVariantConst>(), config);
+  queueNotification(config);
+}
+
+void MQTTManager::configFromJson(JsonVariantConst item, NotificationConfig &config)
+{
+  config.receivedMs = lastMessageReceivedMs;
+
+  // A bare string inside a batch behaves like a plain-text publish.
+  if (item.is<const char *>())
+  {
+    config.message = item.as<const char *>();
+    config.isSimpleMessage = true;
+    config.isScrolling = true;
+    return;
+  }
 
   // Required field
-  config.message = doc["message"] | "No message";
+  config.message = item["message"] | "No message";
 
   // Optional fields with defaults
-  config.isScrolling = doc["scrolling"] | true;
-  config.scrollRepeat = constrain(doc["repeat"] | 1, 1, 10);
-  config.scrollSpeed = constrain(doc["speed"] | 35, 5, 100);
-  config.brightness = constrain(doc["brightness"] | -1, -1, 15);
-  config.flashEffect = doc["flash"] | false;
-  config.flashCount = constrain(doc["flash_count"] | 2, 1, 10);
-  config.holdSeconds = constrain(doc["duration"] | 3, 1, 30);
+  config.isScrolling = item["scrolling"] | true;
+  config.scrollRepeat = constrain(item["repeat"] | 1, 1, 10);
+  // "pps" (pixels per second) takes precedence over the older "speed" (ms per pixel).
+  float pixelsPerSecond = item["pps"] | 0.0f;
+  config.scrollVelocity = (pixelsPerSecond > 0) ? (uint32_t)(constrain(pixelsPerSecond, 1.0f, 400.0f) * SCROLL_VELOCITY_ONE)
+                                                : scrollVelocityFromDelay(constrain(item["speed"] | 35, 5, 100));
+  config.scrollEased = item["ease"] | false;
+  config.brightness = constrain(item["brightness"] | -1, -1, 15);
+  config.showClock = item["clock"] | false;
+  config.flashEffect = item["flash"] | false;
+  config.flashCount = constrain(item["flash_count"] | 2, 1, 10);
+  config.holdSeconds = constrain(item["duration"] | 3, 1, 30);
   config.isSimpleMessage = false;
+}
+
+void MQTTManager::queueNotificationBatch(JsonArrayConst items, bool playlist)
+{
+  if (items.size() == 0)
+  {
+    return;
+  }
+  if (items.size() > MQTT_MAX_BATCH_SIZE)
+  {
+    Serial.println("Notification batch too large (" + String(items.size()) + "), keeping the first " +
+                   String(MQTT_MAX_BATCH_SIZE));
+  }
+
+  // Build the whole group first and only then push it, so a malformed or
+  // oversized batch never leaves a partial group in the queue.
+  std::vector<NotificationConfig> batch;
+  batch.reserve(min(items.size(), MQTT_MAX_BATCH_SIZE));
+  for (JsonVariantConst item : items)
+  {
+    if (batch.size() >= MQTT_MAX_BATCH_SIZE)
+    {
+      break;
+    }
+    if (!item.is<JsonObjectConst>() && !item.is<const char *>())
+    {
+      continue; // Skip numbers/nulls rather than dropping the whole batch
+    }
+    batch.emplace_back();
+    configFromJson(item, batch.back());
+  }
+
+  for (size_t i = 0; i < batch.size(); i++)
+  {
+    batch[i].playlistNext = playlist && (i + 1 < batch.size());
+    queueNotification(batch[i]);
+  }
+}
+
+void MQTTManager::handleNotificationChunk(const String &jsonString)
+{
+  // {"id":"news","seq":0,"final":false,"text":"..."}; display options
+  // (speed, repeat, brightness, ...) are read from the final chunk.
+  JsonDocument doc;
+  DeserializationError error = deserializeJson(doc, jsonString);
+  if (error)
+  {
+    Serial.println("Failed to parse notification chunk");
+    return;
+  }
+
+  String id = doc["id"] | "";
+  int seq = doc["seq"] | -1;
+  if (id.length() == 0 || seq < 0)
+  {
+    Serial.println("Notification chunk needs an \"id\" and a \"seq\"");
+    return;
+  }
 
+  int slot = textStore.append(id, seq, doc["text"] | "", doc["final"] | false);
+  if (slot < 0)
+  {
+    return; // Upload still in progress (or dropped, already logged)
+  }
+
+  NotificationConfig config;
+  configFromJson(doc.as<JsonVariantConst>(), config);
+  config.message = "[" + id + "]"; // Label for logs; the text itself stays in the store
+  config.textSlot = slot;
+  config.isScrolling = true; // A long text can only be shown by scrolling
   queueNotification(config);
 }
 
 void MQTTManager::queueNotification(const NotificationConfig &config)
 {
   notificationQueue.push(config);
+  notificationQueue.back().enqueuedMs = millis();
   Serial.println("Notification queued: " + config.message + " (Queue size: " + String(notificationQueue.size()) + ")");
 }
 
@@ -720,25 +1074,38 @@ void MQTTManager::processNotificationQueue()
     return; // No notifications to process or already showing one
   }
 
-  // Get the next notification from the queue
-  NotificationConfig config = notificationQueue.front();
-  notificationQueue.pop();
+  // A playlist runs its items back to back without handing the display back
+  // to the clock in between; anything else shows exactly one item per call.
+  bool continuePlaylist = true;
+  while (continuePlaylist && !notificationQueue.empty())
+  {
+    // Get the next notification from the queue
+    NotificationConfig config = notificationQueue.front();
+    notificationQueue.pop();
+    config.displayStartMs = millis();
 
-  Serial.println("Processing notification from queue: " + config.message + " (Remaining in queue: " + String(notificationQueue.size()) + ")");
+    Serial.println("Processing notification from queue: " + config.message + " (Remaining in queue: " + String(notificationQueue.size()) + ")");
 
-  // Process the notification
-  if (config.isSimpleMessage)
-  {
-    showNotification(config.message);
-  }
-  else
-  {
-    showAdvancedNotification(config);
+    // Process the notification
+    if (config.isSimpleMessage)
+    {
+      showNotification(config.message);
+    }
+    else
+    {
+      showAdvancedNotification(config);
+    }
+
+    config.displayEndMs = millis();
+    recordNotificationLatency(config);
+    textStore.release(config.textSlot); // No-op for ordinary notifications
+    continuePlaylist = config.playlistNext;
   }
 }
 
 void MQTTManager::playAnimation(const String &animationType)
 {
+  HEAP_AUDIT_SCOPE(HEAP_DISPLAY);
   if (showingNotification)
   {
     return; // Skip if notification in progress
@@ -746,125 +1113,35 @@ void MQTTManager::playAnimation(const String &animationType)
 
   showingNotification = true; // Block other displays during animation
 
-  if (animationType == "heart")
+  // An uploaded animation takes precedence over a built-in of the same name,
+  // even when it turns out to be broken.
+  bool played = false;
+  bool fromFile = false;
+  if (filesystemAvailable && AnimationPlayer::isValidName(animationType) &&
+      LittleFS.exists(AnimationPlayer::pathFor(animationType)))
   {
-    // Heart animation - 4 beats
-    Max72xxPanel &matrix = display.getMatrix();
-    for (int repeat = 0; repeat < 4; repeat++)
-    {
-      // Small heart
-      display.fillScreen(LOW);
-      matrix.drawPixel(14, 2, HIGH);
-      matrix.drawPixel(15, 2, HIGH);
-      matrix.drawPixel(17, 2, HIGH);
-      matrix.drawPixel(18, 2, HIGH);
-      matrix.drawPixel(13, 3, HIGH);
-      matrix.drawPixel(16, 3, HIGH);
-      matrix.drawPixel(19, 3, HIGH);
-      matrix.drawPixel(14, 4, HIGH);
-      matrix.drawPixel(18, 4, HIGH);
-      matrix.drawPixel(15, 5, HIGH);
-      matrix.drawPixel(17, 5, HIGH);
-      matrix.drawPixel(16, 6, HIGH);
-      display.write();
-      serviceDelay(500);
-
-      // Large heart
-      display.fillScreen(LOW);
-      matrix.drawPixel(13, 1, HIGH);
-      matrix.drawPixel(14, 1, HIGH);
-      matrix.drawPixel(15, 1, HIGH);
-      matrix.drawPixel(17, 1, HIGH);
-      matrix.drawPixel(18, 1, HIGH);
-      matrix.drawPixel(19, 1, HIGH);
-      matrix.drawPixel(12, 2, HIGH);
-      matrix.drawPixel(16, 2, HIGH);
-      matrix.drawPixel(20, 2, HIGH);
-      matrix.drawPixel(12, 3, HIGH);
-      matrix.drawPixel(20, 3, HIGH);
-      matrix.drawPixel(13, 4, HIGH);
-      matrix.drawPixel(19, 4, HIGH);
-      matrix.drawPixel(14, 5, HIGH);
-      matrix.drawPixel(18, 5, HIGH);
-      matrix.drawPixel(15, 6, HIGH);
-      matrix.drawPixel(17, 6, HIGH);
-      matrix.drawPixel(16, 7, HIGH);
-      display.write();
-      serviceDelay(500);
-    }
+    FileAnimationSource source(AnimationPlayer::pathFor(animationType));
+    fromFile = source.isOpen();
+    played = fromFile && playAnimationFrom(source);
   }
-  else if (animationType == "wave")
+  size_t length = 0;
+  const uint8_t *builtin = AnimationPlayer::builtin(animationType, length);
+  if (!fromFile && builtin != nullptr)
   {
-    // Wave animation
-    Max72xxPanel &matrix = display.getMatrix();
-    for (int x = 0; x < 48; x++)
-    {
-      display.fillScreen(LOW);
-      for (int i = 0; i < 32; i += 2)
-      {
-        int y = 4 + sin((x + i) * 0.3) * 2.5;
-        if (y >= 0 && y < 8)
-        {
-          matrix.drawPixel(i, y, HIGH);
-        }
-      }
-      display.write();
-      serviceDelay(80);
-    }
+    ProgmemAnimationSource source(builtin, length);
+    played = playAnimationFrom(source);
   }
-  else if (animationType == "pulse")
-  {
-    // Pulse animation
-    Max72xxPanel &matrix = display.getMatrix();
-
-    // Expand from center
-    for (int radius = 1; radius <= 8; radius++)
-    {
-      display.fillScreen(LOW);
-      for (int x = 16 - radius; x <= 16 + radius && x < 32; x++)
-      {
-        for (int y = 4 - radius / 2; y <= 4 + radius / 2 && y >= 0 && y < 8; y++)
-        {
-          if (x >= 0 && x < 32 && y >= 0 && y < 8)
-          {
-            if (abs(x - 16) + abs(y - 4) == radius || abs(x - 16) + abs(y - 4) == radius - 1)
-            {
-              matrix.drawPixel(x, y, HIGH);
-            }
-          }
-        }
-      }
-      display.write();
-      serviceDelay(200);
-    }
 
-    // Contract back to center
-    for (int radius = 8; radius >= 1; radius--)
-    {
-      display.fillScreen(LOW);
-      if (radius <= 3)
-      {
-        matrix.drawPixel(16, 4, HIGH);
-        if (radius > 1)
-        {
-          matrix.drawPixel(15, 4, HIGH);
-          matrix.drawPixel(17, 4, HIGH);
-          matrix.drawPixel(16, 3, HIGH);
-          matrix.drawPixel(16, 5, HIGH);
-        }
-      }
-      display.write();
-      serviceDelay(200);
-    }
-  }
-  else
+  if (!played)
   {
-    // Unknown animation - show error pattern
+    // Unknown or corrupt animation - show error pattern
     for (int i = 0; i < 3; i++)
     {
       display.fillScreen(HIGH);
+      display.write();
       serviceDelay(200);
       display.fillScreen(LOW);
+      display.write();
       serviceDelay(200);
     }
   }
@@ -872,3 +1149,39 @@ void MQTTManager::playAnimation(const String &animationType)
   showingNotification = false;
   updateBrightnessBasedOnTime();
 }
+
+bool MQTTManager::playAnimationFrom(AnimationSource &source)
+{
+  AnimationPlayer player(source);
+  if (!player.begin())
+  {
+    Serial.println("Animation: not a valid animation file");
+    return false;
+  }
+
+  // Frames decode straight into the content layer, centred on the panel.
+  FrameLayer &layer = display.getCanvas();
+  display.fillScreen(LOW);
+  int16_t x0 = (layer.width() - player.width()) / 2;
+
+  // Pace against the animation's own timeline, so decode and refresh time
+  // don't stretch it.
+  unsigned long start = millis();
+  unsigned long due = 0;
+  unsigned long duration;
+  unsigned int frames = 0;
+  while ((duration = player.nextFrame(layer, x0)) > 0)
+  {
+    display.write();
+    frames++;
+    due += duration;
+    unsigned long elapsed = millis() - start;
+    serviceDelay(due > elapsed ? due - elapsed : 0);
+  }
+  if (player.isCorrupt())
+  {
+    Serial.println("Animation: corrupt data after " + String(frames) + " frames");
+    return false;
+  }
+  return true;
+}
@@ -5,8 +5,15 @@
 #include <LittleFS.h>
 #include <ArduinoJson.h>
 #include <queue>
+#include <vector>
 #include "DisplayManager.h"
 #include "TimeManager.h"
+#include "Histogram.h"
+#include "TextStore.h"
+#include "Animation.h"
+#include "RateLimiter.h"
+#include "SettingsStore.h"
+#include "MqttTopics.h"
 
 // Notification configuration structure
 struct NotificationConfig
@@ -14,12 +21,23 @@ struct NotificationConfig
   String message;
   bool isScrolling = true;      // true = scroll, false = static
   int scrollRepeat = 1;         // how many times to scroll (1-10)
-  int scrollSpeed = 35;         // scroll speed in ms (5-100)
+  uint32_t scrollVelocity = 1000UL * SCROLL_VELOCITY_ONE / 35; // px/s, 24.8 fixed point (default = 35 ms per pixel)
+  bool scrollEased = false;     // speed up from rest and slow down as the text leaves
+  bool showClock = false;       // scroll beside a compact clock instead of over the whole panel
   int brightness = -1;          // notification brightness (-1 = use current, 0-15)
   bool flashEffect = false;     // quick fade out/in before holding (static messages only)
   int flashCount = 2;           // number of fade pulses (1-10)
   int holdSeconds = 3;          // how long static text stays on screen (1-30 s)
   bool isSimpleMessage = false; // true if this is a simple string message
+  bool playlistNext = false;    // batch playlist: start the next queued item without returning to the clock
+  int textSlot = -1;            // TextStore slot holding a chunk-uploaded text (-1 = use `message`)
+
+  // Latency trace (millis()). Filled in as the notification moves from the
+  // MQTT callback through the queue onto the panel; 0 = not reached yet.
+  unsigned long receivedMs = 0;     // MQTT callback entered
+  unsigned long enqueuedMs = 0;     // parsed and pushed onto the queue
+  unsigned long displayStartMs = 0; // popped and started drawing
+  unsigned long displayEndMs = 0;   // finished, display handed back to the clock
 };
 
 // Timing constants
@@ -27,8 +45,14 @@ const unsigned long MQTT_RECONNECT_INTERVAL = 5000; // Time between reconnect at
 const int MQTT_BUFFER_SIZE = 1024;                  // MQTT buffer size for discovery messages
 const int MQTT_CONNECT_TIMEOUT_MS = 3000;           // Max blocking time for TCP connect (ms)
 const uint16_t MQTT_SOCKET_TIMEOUT_S = 3;           // Max blocking time for MQTT handshake/reads (s)
-const unsigned long MQTT_STATUS_PUBLISH_INTERVAL = 60000UL; // Periodic status refresh (ms)
+const unsigned long MQTT_STATUS_PUBLISH_INTERVAL = 60000UL; // Periodic status refresh so HA sensors stay current (ms)
 const int NOTIFICATION_FADE_STEP_MS = 25;                   // Per-step delay of the static-notification fade pulse (ms)
+const uint8_t MQTT_COMMAND_BURST = 3;                       // Settings commands accepted back to back per topic
+const unsigned long MQTT_COMMAND_REFILL_MS = 1000;          // ...then one per topic per second; extras coalesce (latest wins)
+const unsigned long MQTT_DISCOVERY_REFILL_MS = 30000UL;     // Min spacing of discovery re-sends requested over MQTT
+const unsigned long SETTINGS_SAVE_DEBOUNCE_MS = 5000;       // Quiet period before dirty settings are written to flash
+const size_t MQTT_MAX_BATCH_SIZE = 16;                       // Max notifications accepted from one JSON array
+const unsigned long MQTT_METRICS_PUBLISH_INTERVAL = 300000UL; // Latency metrics window / publish period (ms)
 
 class MQTTManager
 {
@@ -37,16 +61,19 @@ public:
 
   // MQTT operations
   void initialize();
-  void loop();
-  void keepAlive(); // Pump the MQTT client only (safe to call mid-display)
-  bool tryReconnect(); // Non-blocking reconnect attempt
+  void loop();         // Pump client, pending commands, settings flush, notification queue
+  void keepAlive();    // Pump the MQTT client only (safe to call mid-display)
+  bool tryReconnect(); // One reconnect attempt if disconnected (scheduled every MQTT_RECONNECT_INTERVAL)
   bool isConnected();
   bool isFilesystemAvailable() const { return filesystemAvailable; }
+  void flushSettings(); // Write pending settings now (before OTA / reboot)
 
   // Message handling
   void sendStatus(const String &status);
   void sendDiscoveryConfig();
   void publishNotificationHelp(); // Retained usage docs shown as HA attributes
+  void publishAnimationSelect();  // Again whenever an animation is uploaded or deleted
+  void sendMetrics();             // Publish heap telemetry; publish and reset the latency, power (and loop profile) window
 
   // Brightness management
   void setDayBrightness(int brightness);
@@ -55,6 +82,7 @@ public:
   void setNightStartMinutes(int minutes);
   void updateBrightnessBasedOnTime();
   int currentAutoBrightness(); // Day or night brightness for the current time
+  bool isDayTime();
 
   // Getters for current settings
   int getDayBrightness() const { return dayBrightness; }
@@ -62,6 +90,8 @@ public:
   int getDayStartMinutes() const { return dayStartMinutes; }
   int getNightStartMinutes() const { return nightStartMinutes; }
   bool isShowingNotification() const { return showingNotification; }
+  unsigned long getDroppedCommands() const { return droppedCommands; }
+  unsigned long getSettingsWrites() const { return settingsWrites; }
 
 private:
   DisplayManager &display;
@@ -81,6 +111,40 @@ private:
   bool showingNotification;
   std::queue<NotificationConfig> notificationQueue;
   NotificationConfig currentConfig;
+  TextStore textStore; // Long texts uploaded in chunks on TOPIC_NOTIFICATION_CHUNK
+
+  // Notification latency metrics for the current window (ms). Ingest is
+  // callback -> queued, queue wait is queued -> on panel, display is on panel
+  // -> back to clock. Reset every MQTT_METRICS_PUBLISH_INTERVAL.
+  unsigned long lastMessageReceivedMs; // Set on callback entry, read by the parsers
+  Histogram ingestLatency;
+  Histogram queueWaitLatency;
+  Histogram displayDuration;
+  void recordNotificationLatency(const NotificationConfig &config);
+
+  // Per-topic token buckets for the settings commands. A command arriving
+  // with no token left is parked in `pending` (a newer one replaces it and
+  // counts as dropped) and applied from loop() once a token frees up.
+  enum SettingsCommand
+  {
+    CMD_DAY_BRIGHTNESS,
+    CMD_NIGHT_BRIGHTNESS,
+    CMD_DAY_START,
+    CMD_NIGHT_START,
+    CMD_COUNT
+  };
+  struct RateLimitedCommand
+  {
+    TokenBucket bucket{MQTT_COMMAND_BURST, MQTT_COMMAND_REFILL_MS};
+    bool pending = false;
+    int value = 0;
+  };
+  RateLimitedCommand commands[CMD_COUNT];
+  TokenBucket discoveryBucket{1, MQTT_DISCOVERY_REFILL_MS};
+  unsigned long droppedCommands;
+  bool submitCommand(SettingsCommand command, int value); // true if applied now
+  void applyCommand(SettingsCommand command, int value);
+  void applyPendingCommands();
 
   // Discovery helpers
   String getDeviceId();     // Stable per-device id derived from the MAC
@@ -88,36 +152,53 @@ private:
   // Publish one retained discovery config. `fields` is the entity-specific JSON
   // body (no braces); this wraps it with the shared device block and topic.
   void publishDiscovery(const String &component, const String &objectId, const String &fields);
+  static String discoveryTopic(const String &component, const String &objectId);
 
   // Helper functions
   static void mqttCallback(char *topic, byte *payload, unsigned int length);
-  void handleMessage(const String &topic, const String &message);
+  void handleMessage(MqttTopic topic, const String &message);
+  bool publish(MqttTopic topic, const char *payload, bool retained = false);
   void showNotification(const String &message);
   void showAdvancedNotification(const NotificationConfig &config);
   void parseNotificationJson(const String &jsonString);
+  // Fill `config` from one batch element: a notification object or a plain string.
+  void configFromJson(JsonVariantConst item, NotificationConfig &config);
+  void queueNotificationBatch(JsonArrayConst items, bool playlist);
+  void handleNotificationChunk(const String &jsonString);
   void processNotificationQueue();
   void queueNotification(const NotificationConfig &config);
   void playAnimation(const String &animationType);
-  bool isDayTime();
+  bool playAnimationFrom(AnimationSource &source); // False if it is not an animation or is corrupt
 
   // Time-of-day helpers for HH:MM schedule handling
   static String minutesToTimeString(int minutes);      // e.g. 420 -> "07:00:00"
   static int parseTimeStringToMinutes(const String &value); // "HH:MM[:SS]" -> minutes, -1 if invalid
 
   // Reconnection tracking
-  unsigned long lastReconnectAttempt;
   int reconnectAttempts;
-
-  // Periodic status refresh so HA sensors (e.g. Day/Night mode) stay current
-  // even when no command arrives.
-  unsigned long lastStatusPublish;
+  bool bootReportPublished; // StallMonitor report and boot timeline
 
   // Filesystem status
   bool filesystemAvailable;
 
-  // SPIFFS storage functions
-  void loadSettings();
+  // Settings persistence. The binary SettingsStore is the primary copy;
+  // the old LittleFS JSON file is only read once to migrate it.
+  SettingsStore settingsStore;
+  bool loadSettings();          // From the binary store; false if it holds nothing yet
+  void migrateLegacySettings(); // One-time import of /clock_settings.json
   void saveSettings();
+  ClockSettings currentSettings() const;
+  void applySettings(const ClockSettings &settings);
+
+  // Debounced persistence: setters only mark the settings dirty; loop()
+  // writes them once they have been quiet for SETTINGS_SAVE_DEBOUNCE_MS.
+  // `persisted` mirrors what is on flash so identical writes are skipped.
+  ClockSettings persisted;
+  bool persistedValid;
+  bool settingsDirty;
+  unsigned long lastSettingsChange;
+  unsigned long settingsWrites; // Flash writes since boot
+  void markSettingsDirty();
 
   // Static reference for callback
   static MQTTManager *instance;
@@ -0,0 +1,87 @@
+#include "MqttTopics.h"
+#include "Settings.h"
+
+// Compile-time joined topic strings. Order must match enum MqttTopic.
+#define MQTT_TOPIC_ENTRY(name, suffix)                                          \
+  static_assert(sizeof(MQTT_TOPIC_PREFIX suffix) <= MQTT_TOPIC_BUFFER_SIZE,     \
+                "topic too long for MQTT_TOPIC_BUFFER_SIZE");                   \
+  static const char name[] PROGMEM = MQTT_TOPIC_PREFIX suffix;
+MQTT_TOPIC_ENTRY(TOPIC_STR_NOTIFICATION, "/notification")
+MQTT_TOPIC_ENTRY(TOPIC_STR_NOTIFICATION_CHUNK, "/notification/chunk")
+MQTT_TOPIC_ENTRY(TOPIC_STR_NOTIFICATION_HELP, "/notification/help") // Retained usage docs (HA attributes)
+MQTT_TOPIC_ENTRY(TOPIC_STR_ANIMATION, "/animation")
+MQTT_TOPIC_ENTRY(TOPIC_STR_BRIGHTNESS_DAY, "/brightness/day")
+MQTT_TOPIC_ENTRY(TOPIC_STR_BRIGHTNESS_NIGHT, "/brightness/night")
+MQTT_TOPIC_ENTRY(TOPIC_STR_SCHEDULE_DAY_START, "/schedule/day_start")
+MQTT_TOPIC_ENTRY(TOPIC_STR_SCHEDULE_NIGHT_START, "/schedule/night_start")
+MQTT_TOPIC_ENTRY(TOPIC_STR_DISCOVERY, "/discovery")
+MQTT_TOPIC_ENTRY(TOPIC_STR_STATUS, "/status")
+MQTT_TOPIC_ENTRY(TOPIC_STR_METRICS, "/metrics") // Heap + notification latency window (JSON)
+MQTT_TOPIC_ENTRY(TOPIC_STR_METRICS_LOOP, "/metrics/loop") // Loop timing window (LOOP_PROFILER builds only)
+MQTT_TOPIC_ENTRY(TOPIC_STR_DIAGNOSTICS, "/diagnostics") // Previous boot's reset reason + stalls (retained)
+MQTT_TOPIC_ENTRY(TOPIC_STR_BOOT, "/boot") // This boot's phase timeline (retained)
+#undef MQTT_TOPIC_ENTRY
+
+static const char *const TOPIC_TABLE[TOPIC_COUNT] PROGMEM = {
+    TOPIC_STR_NOTIFICATION,
+    TOPIC_STR_NOTIFICATION_CHUNK,
+    TOPIC_STR_NOTIFICATION_HELP,
+    TOPIC_STR_ANIMATION,
+    TOPIC_STR_BRIGHTNESS_DAY,
+    TOPIC_STR_BRIGHTNESS_NIGHT,
+    TOPIC_STR_SCHEDULE_DAY_START,
+    TOPIC_STR_SCHEDULE_NIGHT_START,
+    TOPIC_STR_DISCOVERY,
+    TOPIC_STR_STATUS,
+    TOPIC_STR_METRICS,
+    TOPIC_STR_METRICS_LOOP,
+    TOPIC_STR_DIAGNOSTICS,
+    TOPIC_STR_BOOT,
+};
+
+// Bit n set = topic n is subscribed to.
+static const uint16_t COMMAND_TOPICS =
+    (1u << TOPIC_NOTIFICATION) | (1u << TOPIC_NOTIFICATION_CHUNK) | (1u << TOPIC_ANIMATION) |
+    (1u << TOPIC_BRIGHTNESS_DAY) | (1u << TOPIC_BRIGHTNESS_NIGHT) | (1u << TOPIC_SCHEDULE_DAY_START) |
+    (1u << TOPIC_SCHEDULE_NIGHT_START) | (1u << TOPIC_DISCOVERY);
+
+static const char *topicPointer(MqttTopic topic)
+{
+  return (const char *)pgm_read_ptr(&TOPIC_TABLE[topic]);
+}
+
+const __FlashStringHelper *mqttTopic(MqttTopic topic)
+{
+  return FPSTR(topicPointer(topic));
+}
+
+const char *mqttTopicCopy(MqttTopic topic, char *buffer)
+{
+  strncpy_P(buffer, topicPointer(topic), MQTT_TOPIC_BUFFER_SIZE - 1);
+  buffer[MQTT_TOPIC_BUFFER_SIZE - 1] = '\0';
+  return buffer;
+}
+
+bool mqttTopicIsCommand(MqttTopic topic)
+{
+  return topic < TOPIC_COUNT && (COMMAND_TOPICS & (1u << topic));
+}
+
+MqttTopic mqttTopicFind(const char *topic)
+{
+  // All topics share the prefix: reject foreign topics with one compare.
+  static const size_t prefixLength = sizeof(MQTT_TOPIC_PREFIX) - 1;
+  if (strncmp(topic, MQTT_TOPIC_PREFIX, prefixLength) != 0)
+  {
+    return TOPIC_UNKNOWN;
+  }
+
+  for (uint8_t i = 0; i < TOPIC_COUNT; i++)
+  {
+    if (mqttTopicIsCommand((MqttTopic)i) && strcmp_P(topic, topicPointer((MqttTopic)i)) == 0)
+    {
+      return (MqttTopic)i;
+    }
+  }
+  return TOPIC_UNKNOWN;
+}
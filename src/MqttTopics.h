@@ -0,0 +1,40 @@
+#pragma once
+#include "Arduino.h"
+
+// Every MQTT topic the clock uses. The full topic strings are joined with
+// MQTT_TOPIC_PREFIX at compile time and live in a flash (PROGMEM) table, so
+// they cost no heap and no static-initialisation work.
+enum MqttTopic : uint8_t
+{
+  TOPIC_NOTIFICATION,
+  TOPIC_NOTIFICATION_CHUNK,
+  TOPIC_NOTIFICATION_HELP,
+  TOPIC_ANIMATION,
+  TOPIC_BRIGHTNESS_DAY,
+  TOPIC_BRIGHTNESS_NIGHT,
+  TOPIC_SCHEDULE_DAY_START,
+  TOPIC_SCHEDULE_NIGHT_START,
+  TOPIC_DISCOVERY,
+  TOPIC_STATUS,
+  TOPIC_METRICS,
+  TOPIC_METRICS_LOOP,
+  TOPIC_DIAGNOSTICS,
+  TOPIC_BOOT,
+  TOPIC_COUNT,
+  TOPIC_UNKNOWN = TOPIC_COUNT
+};
+
+const size_t MQTT_TOPIC_BUFFER_SIZE = 64; // Longest topic + terminator, checked at compile time
+
+// Flash-resident topic, for String concatenation and Serial output.
+const __FlashStringHelper *mqttTopic(MqttTopic topic);
+
+// Copy a topic into a RAM buffer (MQTT_TOPIC_BUFFER_SIZE bytes) for APIs such
+// as PubSubClient that need a plain char pointer. Returns `buffer`.
+const char *mqttTopicCopy(MqttTopic topic, char *buffer);
+
+// Inbound topics the clock subscribes to on every (re)connect.
+bool mqttTopicIsCommand(MqttTopic topic);
+
+// Map an incoming topic back to its id (TOPIC_UNKNOWN if it isn't ours).
+MqttTopic mqttTopicFind(const char *topic);
@@ -1,5 +1,8 @@
 #include "OTAManager.h"
 #include "Settings.h"
+#include "BackgroundService.h"
+#include "StallMonitor.h"
+#include "CpuFrequency.h"
 
 // Static member initialization
 OTAManager *OTAManager::instance = nullptr;
@@ -12,13 +15,13 @@ OTAManager::OTAManager(DisplayManager &displayRef) : display(displayRef)
 void OTAManager::initialize()
 {
   // Setup mDNS
-  if (MDNS.begin(DEVICE_HOSTNAME.c_str()))
+  if (MDNS.begin(DEVICE_HOSTNAME))
   {
     Serial.println("mDNS responder started");
   }
 
   // Setup OTA
-  ArduinoOTA.setHostname(DEVICE_HOSTNAME.c_str());
+  ArduinoOTA.setHostname(DEVICE_HOSTNAME);
   ArduinoOTA.setPassword("mqtt-clock-ota"); // Change this to your preferred password
 
   ArduinoOTA.onStart(onStart);
@@ -29,7 +32,7 @@ void OTAManager::initialize()
   ArduinoOTA.begin();
 
   Serial.println("OTA update ready");
-  Serial.println("Hostname: " + DEVICE_HOSTNAME);
+  Serial.println("Hostname: " + String(DEVICE_HOSTNAME));
   Serial.println("OTA Password: mqtt-clock-ota");
 }
 
@@ -53,6 +56,17 @@ void OTAManager::onStart()
 
   Serial.println("Start updating " + type);
 
+  // Persist debounced settings before flash is taken over by the update.
+  prepareForRestart();
+
+  // Receive and write the image at full speed; released in onEnd/onError.
+  CpuFrequency::boost();
+
+  // ArduinoOTA.handle() does not return until the whole image is in, so
+  // the transfer is tagged as an expected block. The caller's STALL_SECTION
+  // restores its own tag once handle() returns.
+  StallMonitor::enter(STALL_OTA_TRANSFER);
+
   if (instance)
   {
     instance->display.fillScreen(false);
@@ -63,7 +77,13 @@ void OTAManager::onStart()
 
 void OTAManager::onEnd()
 {
+  STALL_SECTION(STALL_OTA_END);
   Serial.println("\nEnd");
+  CpuFrequency::release();
+
+  // No clock frame ran during the transfer: save the time again for the
+  // warm boot that follows.
+  prepareForRestart();
 
   if (instance)
   {
@@ -91,6 +111,7 @@ void OTAManager::onProgress(unsigned int progress, unsigned int total)
 void OTAManager::onError(ota_error_t error)
 {
   Serial.printf("Error[%u]: ", error);
+  CpuFrequency::release();
   String errorMsg = "Err";
 
   if (error == OTA_AUTH_ERROR)
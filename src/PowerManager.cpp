@@ -0,0 +1,95 @@
+#include "PowerManager.h"
+#include <ESP8266WiFi.h>
+
+// Matches the SDK default, so nothing changes until the first setMode().
+PowerMode PowerManager::mode = POWER_MODEM_SLEEP;
+unsigned long PowerManager::windowStart = 0;
+uint64_t PowerManager::idleUs = 0;
+unsigned long PowerManager::modeSince = 0;
+unsigned long PowerManager::modeMs[POWER_MODE_COUNT] = {};
+
+static const char *const POWER_MODE_NAMES[POWER_MODE_COUNT] = {"none", "modem", "light"};
+
+void PowerManager::setMode(PowerMode newMode)
+{
+  if (newMode == mode)
+  {
+    return;
+  }
+
+  static const WiFiSleepType_t sleepTypes[POWER_MODE_COUNT] = {WIFI_NONE_SLEEP, WIFI_MODEM_SLEEP, WIFI_LIGHT_SLEEP};
+  if (!WiFi.setSleepMode(sleepTypes[newMode]))
+  {
+    Serial.println("Failed to set Wi-Fi sleep mode " + String(POWER_MODE_NAMES[newMode]));
+    return;
+  }
+
+  closeModePeriod();
+  mode = newMode;
+  Serial.println("Power mode: " + String(POWER_MODE_NAMES[mode]));
+}
+
+void PowerManager::keepAwake()
+{
+  if (mode == POWER_LIGHT_SLEEP)
+  {
+    setMode(POWER_MODEM_SLEEP);
+  }
+}
+
+void PowerManager::idle(unsigned long ms)
+{
+  if (ms == 0)
+  {
+    yield();
+    return;
+  }
+
+  // delay() hands the CPU to the SDK, which applies the Wi-Fi sleep mode.
+  unsigned long start = micros();
+  delay(ms);
+  idleUs += (unsigned long)(micros() - start);
+}
+
+void PowerManager::closeModePeriod()
+{
+  unsigned long now = millis();
+  modeMs[mode] += now - modeSince;
+  modeSince = now;
+}
+
+String PowerManager::toJson()
+{
+  closeModePeriod();
+
+  unsigned long windowMs = millis() - windowStart;
+  unsigned long idleMs = (unsigned long)(idleUs / 1000);
+  if (idleMs > windowMs)
+  {
+    idleMs = windowMs;
+  }
+  unsigned long idlePct = windowMs ? (unsigned long)((uint64_t)idleMs * 100 / windowMs) : 0;
+
+  String json = "{\"mode\":\"" + String(POWER_MODE_NAMES[mode]) + "\",";
+  json += "\"awake_ms\":" + String(windowMs - idleMs) + ",";
+  json += "\"idle_ms\":" + String(idleMs) + ",";
+  json += "\"idle_pct\":" + String(idlePct) + ",";
+  json += "\"mode_ms\":{";
+  for (int i = 0; i < POWER_MODE_COUNT; i++)
+  {
+    json += String(i ? "," : "") + "\"" + POWER_MODE_NAMES[i] + "\":" + String(modeMs[i]);
+  }
+  json += "}}";
+  return json;
+}
+
+void PowerManager::reset()
+{
+  windowStart = millis();
+  modeSince = windowStart;
+  idleUs = 0;
+  for (int i = 0; i < POWER_MODE_COUNT; i++)
+  {
+    modeMs[i] = 0;
+  }
+}
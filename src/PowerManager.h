@@ -0,0 +1,58 @@
+#pragma once
+#include "Arduino.h"
+
+// Wi-Fi power save level while the loop is idle between scheduler deadlines.
+enum PowerMode : uint8_t
+{
+  POWER_NO_SLEEP,    // Radio always on (lowest latency, highest draw)
+  POWER_MODEM_SLEEP, // Radio off between DTIM beacons, CPU keeps running
+  POWER_LIGHT_SLEEP, // Radio and CPU clock gated while idle; wakes for beacons and timers
+  POWER_MODE_COUNT
+};
+
+// What the clock does in each part of the day/night schedule: how deeply to
+// sleep and how often the network pump and clock render tasks wake up.
+struct PowerPolicy
+{
+  PowerMode mode;
+  unsigned long networkPollMs;
+  unsigned long renderIntervalMs;
+};
+
+const PowerPolicy POWER_POLICY_DAY = {POWER_MODEM_SLEEP, 50, 250};
+// Night: the panel is dim and nobody is watching closely. MQTT/HTTP still
+// answer within a beacon interval plus one 200 ms poll.
+const PowerPolicy POWER_POLICY_NIGHT = {POWER_LIGHT_SLEEP, 200, 500};
+const unsigned long POWER_POLICY_CHECK_INTERVAL_MS = 1000; // How often the schedule is re-evaluated
+
+// Idle strategy and awake/idle accounting. The main loop hands every wait
+// between scheduler deadlines to idle(), which is the only place the
+// firmware sleeps on purpose, so idle time is measured exactly there;
+// everything else counts as awake. Totals cover the current metrics window.
+//
+// Light sleep can stretch short delay()s, so blocking display work (scrolls,
+// fades) calls keepAwake() through serviceBackground() and drops to modem
+// sleep until the next policy check finds the display idle again.
+class PowerManager
+{
+public:
+  static void setMode(PowerMode mode); // No-op if unchanged
+  static PowerMode getMode() { return mode; }
+  static void keepAwake();
+
+  static void idle(unsigned long ms); // Sleep until the next deadline
+
+  // {"mode":"light","awake_ms":..,"idle_ms":..,"idle_pct":..,
+  //  "mode_ms":{"none":..,"modem":..,"light":..}}
+  static String toJson();
+  static void reset(); // Start a new window (called after each MQTT publish)
+
+private:
+  static PowerMode mode;
+  static unsigned long windowStart;
+  static uint64_t idleUs;
+  static unsigned long modeSince;
+  static unsigned long modeMs[POWER_MODE_COUNT];
+
+  static void closeModePeriod();
+};
@@ -0,0 +1,45 @@
+#include "RateLimiter.h"
+
+TokenBucket::TokenBucket(uint8_t cap, unsigned long refill)
+    : capacity(cap), tokens(cap), refillMs(refill), lastRefill(millis())
+{
+}
+
+void TokenBucket::refill()
+{
+  unsigned long now = millis();
+  unsigned long elapsed = now - lastRefill;
+  if (elapsed < refillMs)
+  {
+    return;
+  }
+
+  unsigned long earned = elapsed / refillMs;
+  if (tokens + earned >= capacity)
+  {
+    tokens = capacity;
+    lastRefill = now;
+  }
+  else
+  {
+    tokens += earned;
+    lastRefill += earned * refillMs; // Keep the remainder towards the next token
+  }
+}
+
+bool TokenBucket::tryTake()
+{
+  refill();
+  if (tokens == 0)
+  {
+    return false;
+  }
+  tokens--;
+  return true;
+}
+
+uint8_t TokenBucket::available()
+{
+  refill();
+  return tokens;
+}
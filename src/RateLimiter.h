@@ -0,0 +1,22 @@
+#pragma once
+#include "Arduino.h"
+
+// Classic token bucket: up to `capacity` commands may arrive back to back,
+// after which one more is allowed every `refillMs`. Used to bound how often a
+// chatty MQTT publisher can make us write flash, touch SPI and republish.
+class TokenBucket
+{
+public:
+  TokenBucket(uint8_t capacity, unsigned long refillMs);
+
+  bool tryTake(); // Consume a token if one is available
+  uint8_t available();
+
+private:
+  uint8_t capacity;
+  uint8_t tokens;
+  unsigned long refillMs;
+  unsigned long lastRefill;
+
+  void refill();
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include "Arduino.h"
+
+// Layout of the RTC user memory (512 bytes that survive a reset but not a
+// power cut). Offsets are in 4-byte blocks, as used by
+// ESP.rtcUserMemoryRead/Write. Blocks 0-31 belong to the core: the OTA
+// updater keeps its boot command there.
+const uint32_t RTC_USER_MEMORY_ADDRESS = 0x60001200;
+const uint32_t RTC_USER_MEMORY_BLOCKS = 128;
+
+const uint32_t RTC_BLOCK_STALL_MONITOR = 32; // StallMonitor record, 8 blocks
+const uint32_t RTC_BLOCK_CLOCK = 40;         // TimeManager's last known time, 3 blocks
+
+// Direct word access, for code that cannot call into the SDK (interrupt
+// handlers). RTC memory must be accessed in whole 32-bit words.
+inline volatile uint32_t *rtcUserMemory(uint32_t block)
+{
+  return (volatile uint32_t *)(RTC_USER_MEMORY_ADDRESS + block * 4);
+}
@@ -0,0 +1,132 @@
+#include "Scheduler.h"
+
+Scheduler::Scheduler() : taskCount(0)
+{
+}
+
+TaskId Scheduler::add(const char *name, unsigned long intervalMs, unsigned long delayMs, TaskPriority priority,
+                      TaskFunction function)
+{
+  if (taskCount >= SCHEDULER_MAX_TASKS)
+  {
+    Serial.println("Scheduler full, cannot add task " + String(name));
+    return -1;
+  }
+
+  Task &task = tasks[taskCount];
+  task.name = name;
+  task.function = function;
+  task.intervalMs = intervalMs;
+  task.dueMs = millis() + delayMs;
+  task.priority = priority;
+  task.armed = true;
+  return taskCount++;
+}
+
+TaskId Scheduler::addPeriodic(const char *name, unsigned long intervalMs, TaskPriority priority,
+                              TaskFunction function, unsigned long firstDelayMs)
+{
+  return add(name, intervalMs, firstDelayMs, priority, function);
+}
+
+TaskId Scheduler::addOnce(const char *name, unsigned long delayMs, TaskPriority priority, TaskFunction function)
+{
+  return add(name, 0, delayMs, priority, function);
+}
+
+void Scheduler::runIn(TaskId id, unsigned long delayMs)
+{
+  if (valid(id))
+  {
+    tasks[id].dueMs = millis() + delayMs;
+    tasks[id].armed = true;
+  }
+}
+
+void Scheduler::setInterval(TaskId id, unsigned long intervalMs)
+{
+  if (valid(id))
+  {
+    tasks[id].intervalMs = intervalMs;
+  }
+}
+
+void Scheduler::cancel(TaskId id)
+{
+  if (valid(id))
+  {
+    tasks[id].armed = false;
+  }
+}
+
+void Scheduler::run()
+{
+  // Each task runs at most once per call, so a task re-armed for "now" waits
+  // for the next call and run() always terminates.
+  bool ran[SCHEDULER_MAX_TASKS] = {};
+
+  while (true)
+  {
+    unsigned long now = millis();
+    int next = -1;
+    for (int i = 0; i < taskCount; i++)
+    {
+      const Task &task = tasks[i];
+      if (!task.armed || ran[i] || !isDue(task, now))
+      {
+        continue;
+      }
+      if (next < 0 || task.priority > tasks[next].priority ||
+          (task.priority == tasks[next].priority && (long)(task.dueMs - tasks[next].dueMs) < 0))
+      {
+        next = i;
+      }
+    }
+    if (next < 0)
+    {
+      return;
+    }
+
+    // Re-arm before running so the task may reschedule or cancel itself.
+    Task &task = tasks[next];
+    ran[next] = true;
+    if (task.intervalMs == 0)
+    {
+      task.armed = false;
+    }
+    else
+    {
+      task.dueMs += task.intervalMs;
+      if (isDue(task, now))
+      {
+        task.dueMs = now + task.intervalMs; // Overran: skip, don't burst
+      }
+    }
+
+    task.function();
+  }
+}
+
+unsigned long Scheduler::msUntilNextDeadline() const
+{
+  unsigned long now = millis();
+  unsigned long wait = SCHEDULER_MAX_SLEEP_MS;
+  for (int i = 0; i < taskCount; i++)
+  {
+    const Task &task = tasks[i];
+    if (!task.armed)
+    {
+      continue;
+    }
+    if (isDue(task, now))
+    {
+      return 0;
+    }
+    unsigned long remaining = task.dueMs - now;
+    if (remaining < wait)
+    {
+      wait = remaining;
+    }
+  }
+  return wait;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "Arduino.h"
+
+// Scheduler limits
+const int SCHEDULER_MAX_TASKS = 12;                 // Fixed task table, no heap allocation
+const unsigned long SCHEDULER_MAX_SLEEP_MS = 1000;  // Upper bound on one idle sleep
+
+typedef void (*TaskFunction)();
+typedef int8_t TaskId; // -1 = invalid / table full
+
+enum TaskPriority : uint8_t
+{
+  TASK_PRIORITY_LOW,
+  TASK_PRIORITY_NORMAL,
+  TASK_PRIORITY_HIGH
+};
+
+// Small cooperative scheduler for loop(). Tasks are plain functions run
+// either periodically or once after a delay. run() executes every task whose
+// deadline has passed, highest priority first (earliest deadline breaks
+// ties), each at most once per call. The caller then idles for
+// msUntilNextDeadline() instead of a fixed loop delay.
+//
+// Tasks run to completion and must not block for long: anything that needs
+// to wait (scrolling, fades) keeps the network alive through
+// serviceBackground() as before. A periodic task that overruns skips the
+// missed runs rather than firing back to back to catch up.
+class Scheduler
+{
+public:
+  Scheduler();
+
+  // `firstDelayMs` = 0 runs the task on the next run() call.
+  TaskId addPeriodic(const char *name, unsigned long intervalMs, TaskPriority priority, TaskFunction function,
+                     unsigned long firstDelayMs = 0);
+  TaskId addOnce(const char *name, unsigned long delayMs, TaskPriority priority, TaskFunction function);
+
+  void runIn(TaskId id, unsigned long delayMs);           // (Re)arm a task, one-shot or periodic
+  void setInterval(TaskId id, unsigned long intervalMs);  // Takes effect from the next run
+  void cancel(TaskId id);                                 // Disarm; runIn() re-arms it
+
+  void run();
+  unsigned long msUntilNextDeadline() const; // Capped at SCHEDULER_MAX_SLEEP_MS
+
+private:
+  struct Task
+  {
+    const char *name;
+    TaskFunction function;
+    unsigned long intervalMs; // 0 = one-shot
+    unsigned long dueMs;
+    TaskPriority priority;
+    bool armed;
+  };
+
+  Task tasks[SCHEDULER_MAX_TASKS];
+  int taskCount;
+
+  TaskId add(const char *name, unsigned long intervalMs, unsigned long delayMs, TaskPriority priority,
+             TaskFunction function);
+  bool valid(TaskId id) const { return id >= 0 && id < taskCount; }
+  static bool isDue(const Task &task, unsigned long now) { return (long)(now - task.dueMs) >= 0; }
+};
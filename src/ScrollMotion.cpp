@@ -0,0 +1,57 @@
+#include "ScrollMotion.h"
+
+uint32_t scrollVelocityFromDelay(int msPerPixel)
+{
+  return (1000UL << SCROLL_VELOCITY_SHIFT) / max(msPerPixel, 1);
+}
+
+ScrollMotion::ScrollMotion(uint32_t pxPerSecond, ScrollProfile profile, uint32_t length)
+    : velocity(max(pxPerSecond, (uint32_t)1)), distance(length), rampMs(0), totalMs(0)
+{
+  if (profile != SCROLL_EASED)
+  {
+    return;
+  }
+
+  // Trapezoid: speed rises linearly for rampMs, holds, then falls for rampMs.
+  // The ramps together cover what rampMs at full speed would, so the
+  // distance takes rampMs longer than at constant speed. Short distances get
+  // shorter ramps.
+  unsigned long cruiseMs = ((uint64_t)distance * 1000UL << SCROLL_VELOCITY_SHIFT) / velocity;
+  rampMs = min(SCROLL_RAMP_MS, cruiseMs);
+  totalMs = cruiseMs + rampMs;
+}
+
+uint32_t ScrollMotion::position(unsigned long elapsedMs) const
+{
+  // Fixed-point px travelled, times 1000 (velocity is per second).
+  uint64_t travelled;
+  if (rampMs == 0)
+  {
+    travelled = (uint64_t)velocity * elapsedMs;
+  }
+  else if (elapsedMs >= totalMs)
+  {
+    return distance;
+  }
+  else if (elapsedMs < rampMs)
+  {
+    travelled = (uint64_t)velocity * elapsedMs * elapsedMs / (2 * rampMs);
+  }
+  else if (elapsedMs + rampMs <= totalMs)
+  {
+    travelled = (uint64_t)velocity * (2 * elapsedMs - rampMs) / 2;
+  }
+  else
+  {
+    uint64_t remainingMs = totalMs - elapsedMs;
+    uint64_t full = ((uint64_t)distance * 1000UL) << SCROLL_VELOCITY_SHIFT;
+    travelled = full - (uint64_t)velocity * remainingMs * remainingMs / (2 * rampMs);
+  }
+  return (uint32_t)((travelled / 1000UL) >> SCROLL_VELOCITY_SHIFT);
+}
+
+unsigned long ScrollMotion::pixelPeriodMs() const
+{
+  return max((1000UL << SCROLL_VELOCITY_SHIFT) / velocity, 1UL);
+}
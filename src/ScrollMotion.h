@@ -0,0 +1,46 @@
+#pragma once
+#include "Arduino.h"
+
+// Scroll velocities are pixels per second in 24.8 fixed point, so speeds
+// between whole pixels per second (and far above what a ms-per-pixel delay
+// can express) are all available.
+const uint8_t SCROLL_VELOCITY_SHIFT = 8;
+const uint32_t SCROLL_VELOCITY_ONE = 1UL << SCROLL_VELOCITY_SHIFT; // 1 px/s
+const unsigned long SCROLL_RAMP_MS = 400; // Speed-up and slow-down time of SCROLL_EASED
+
+enum ScrollProfile : uint8_t
+{
+  SCROLL_CONSTANT, // Full speed from the first frame to the last
+  SCROLL_EASED     // Speed up from rest, and slow down again as the text leaves
+};
+
+// How a text scrolls.
+struct ScrollStyle
+{
+  uint32_t velocity;     // px/s, 24.8 fixed point
+  ScrollProfile profile; // SCROLL_CONSTANT or SCROLL_EASED
+  bool withClock;        // Scroll beside a compact clock
+};
+
+// Velocity equivalent to the older "ms per pixel" speed setting.
+uint32_t scrollVelocityFromDelay(int msPerPixel);
+
+// Position of a scroll over time: whole pixels travelled after a given
+// number of ms. The frame pacer samples it each frame, so the position is
+// exact at any frame rate and late frames simply read a later position.
+class ScrollMotion
+{
+public:
+  // length (px) is only needed by SCROLL_EASED, to know when to slow down.
+  ScrollMotion(uint32_t pxPerSecond, ScrollProfile profile, uint32_t length);
+
+  uint32_t position(unsigned long elapsedMs) const;
+  // Time to move one pixel at full speed.
+  unsigned long pixelPeriodMs() const;
+
+private:
+  uint32_t velocity;
+  uint32_t distance;
+  unsigned long rampMs;  // 0 = constant speed
+  unsigned long totalMs; // SCROLL_EASED: when the distance is covered
+};
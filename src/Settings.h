@@ -16,11 +16,27 @@
 // Time and Display Settings
 const int MINUTES_BETWEEN_DATA_REFRESH = 60; // Time in minutes between data refresh
 const int DISPLAY_SCROLL_SPEED = 35;         // In milliseconds (slow = 35, normal = 25, fast = 15, very fast = 5)
+const int DISPLAY_MAX_FPS = 50;              // cap on the scrolling frame rate; faster speeds move more than one column per frame
 const bool FLASH_ON_SECONDS = true;          // when true the : character in the time will flash on and off as a seconds indicator
+const bool FAST_BOOT = true;                 // after a warm reset skip the intro and show the time kept in RTC memory
+const bool CLOCK_SECONDS_BAR = false;        // when true a bar along the bottom row fills up over each minute
+const bool DISPLAY_TRANSITIONS = true;       // slide changed digits each minute, wipe/dissolve between the clock and notifications
+
+/* Clock digit style
+0: small 5x7 digits, same as the text font
+1: large 5x8 digits, full panel height (default)
+2: bold 6x8 digits
+3: tiny 3x5 digits
+*/
+const int CLOCK_DIGIT_STYLE = 1;
+
+// String settings are plain constexpr char arrays rather than `const String`
+// objects: no heap allocation during static initialisation, and they can be
+// handed straight to APIs that take a const char *.
 
 // API Configuration
-const String TIMEZONE_DB_API_KEY = SECRET_TIMEZONE_DB_API_KEY;
-const String TIMEZONE = "Europe/Oslo";
+constexpr char TIMEZONE_DB_API_KEY[] = SECRET_TIMEZONE_DB_API_KEY;
+constexpr char TIMEZONE[] = "Europe/Oslo";
 // Display Hardware Settings
 // CLK -> D5 (SCK)
 // CS  -> D6
@@ -29,6 +45,7 @@ const int PIN_CS = D6;                       // Attach CS to this pin, DIN to MO
 const int DISPLAY_INTENSITY = 1;             // Brightness (0-15)
 const int NUMBER_OF_HORIZONTAL_DISPLAYS = 4; // default 4 for standard 4 x 1 display Max size of 16
 const int NUMBER_OF_VERTICAL_DISPLAYS = 1;   // default 1 for a single row height
+const unsigned long DISPLAY_REFRESH_INTERVAL_MS = 60000; // re-send panel registers and bitmap (0 = never)
 
 /* LED Rotation for Display panels (3 is default)
 0: no rotation
@@ -39,31 +56,24 @@ const int NUMBER_OF_VERTICAL_DISPLAYS = 1;   // default 1 for a single row heigh
 const int LED_ROTATION = 3;
 
 // Network Settings
-const String DEVICE_HOSTNAME = "ZegarTV";
+constexpr char DEVICE_HOSTNAME[] = "ZegarTV";
 // SSID of the WiFiManager configuration portal shown on first boot / when it
 // cannot join a known network.
-const String WIFI_PORTAL_AP_NAME = "Zegar TV";
+constexpr char WIFI_PORTAL_AP_NAME[] = "Zegar TV";
 
 // MQTT Settings
 // Use the broker's IP rather than a bare hostname: the ESP8266's DNS resolver
 // often can't resolve names like "homeassistant" (that relies on mDNS).
 // Tip: give Home Assistant a DHCP reservation so this IP stays stable.
-const String MQTT_SERVER = "192.168.50.42"; // Home Assistant broker IP
+constexpr char MQTT_SERVER[] = "192.168.50.42"; // Home Assistant broker IP
 const int MQTT_PORT = 1883;
-const String MQTT_USER = SECRET_MQTT_USER;
-const String MQTT_PASSWORD = SECRET_MQTT_PASSWORD;
-const String MQTT_CLIENT_ID = "mqtt-clock";
-const String MQTT_TOPIC_PREFIX = "clock/zegarTV";
+constexpr char MQTT_USER[] = SECRET_MQTT_USER;
+constexpr char MQTT_PASSWORD[] = SECRET_MQTT_PASSWORD;
+constexpr char MQTT_CLIENT_ID[] = "mqtt-clock";
 
-// MQTT Topics
-const String MQTT_TOPIC_NOTIFICATION = MQTT_TOPIC_PREFIX + "/notification";
-const String MQTT_TOPIC_NOTIFICATION_HELP = MQTT_TOPIC_PREFIX + "/notification/help"; // Retained usage docs (HA attributes)
-const String MQTT_TOPIC_ANIMATION = MQTT_TOPIC_PREFIX + "/animation";
-const String MQTT_TOPIC_BRIGHTNESS_DAY = MQTT_TOPIC_PREFIX + "/brightness/day";
-const String MQTT_TOPIC_BRIGHTNESS_NIGHT = MQTT_TOPIC_PREFIX + "/brightness/night";
-const String MQTT_TOPIC_SCHEDULE_DAY_START = MQTT_TOPIC_PREFIX + "/schedule/day_start";
-const String MQTT_TOPIC_SCHEDULE_NIGHT_START = MQTT_TOPIC_PREFIX + "/schedule/night_start";
-const String MQTT_TOPIC_STATUS = MQTT_TOPIC_PREFIX + "/status";
+// MQTT Topics. The prefix is a string literal so each topic can be joined at
+// compile time; the topics themselves are listed in MqttTopics.cpp.
+#define MQTT_TOPIC_PREFIX "clock/zegarTV"
 
 // Brightness Settings
 const int DEFAULT_DAY_BRIGHTNESS = 8;   // Default day brightness (0-15)
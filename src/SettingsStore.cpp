@@ -0,0 +1,206 @@
+#include "SettingsStore.h"
+#include <spi_flash.h>
+
+// Start of the flash sector the linker script reserves for EEPROM emulation
+// (same symbol the core EEPROM library uses), and the end of the filesystem.
+// Nothing else in this firmware uses EEPROM, so that sector belongs to the
+// settings store, as does the one below it when the filesystem (rounded down
+// to its block size) stops short of it.
+extern "C" uint32_t _EEPROM_start;
+extern "C" uint32_t _FS_end;
+
+SettingsStore::SettingsStore()
+    : sectorCount(1), slotCount(SPI_FLASH_SEC_SIZE / SLOT_SIZE), active(0), nextSlot(0), sequence(0), scanned(false)
+{
+  static_assert(sizeof(Record) <= SLOT_SIZE, "settings record must fit its slot");
+  sectors[0] = ((uint32_t)&_EEPROM_start - 0x40200000) / SPI_FLASH_SEC_SIZE;
+  sectors[1] = sectors[0] - 1;
+  if (sectors[1] * SPI_FLASH_SEC_SIZE >= (uint32_t)&_FS_end - 0x40200000)
+  {
+    sectorCount = 2;
+  }
+}
+
+uint32_t SettingsStore::crc32(const uint8_t *data, size_t length)
+{
+  uint32_t crc = 0xFFFFFFFFUL;
+  while (length--)
+  {
+    crc ^= *data++;
+    for (int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+uint32_t SettingsStore::slotAddress(uint8_t index, uint32_t slot) const
+{
+  return sectors[index] * SPI_FLASH_SEC_SIZE + slot * SLOT_SIZE;
+}
+
+bool SettingsStore::readSlot(uint8_t index, uint32_t slot, Record &record)
+{
+  if (!ESP.flashRead(slotAddress(index, slot), (uint32_t *)&record, sizeof(Record)))
+  {
+    return false;
+  }
+  return record.magic == RECORD_MAGIC && record.version == RECORD_VERSION && record.size == sizeof(Record) &&
+         record.crc == crc32((const uint8_t *)&record, offsetof(Record, crc));
+}
+
+bool SettingsStore::slotErased(uint8_t index, uint32_t slot)
+{
+  uint32_t words[SLOT_SIZE / 4];
+  if (!ESP.flashRead(slotAddress(index, slot), words, sizeof(words)))
+  {
+    return false;
+  }
+  for (uint32_t i = 0; i < SLOT_SIZE / 4; i++)
+  {
+    if (words[i] != 0xFFFFFFFFUL)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t SettingsStore::firstFreeSlot(uint8_t index)
+{
+  // Slots are programmed in order, so everything after the last non-erased
+  // slot is free. Torn records still occupy their slot.
+  for (uint32_t slot = slotCount; slot > 0; slot--)
+  {
+    if (!slotErased(index, slot - 1))
+    {
+      return slot;
+    }
+  }
+  return 0;
+}
+
+bool SettingsStore::newestIn(uint8_t index, Record &newest)
+{
+  bool found = false;
+  uint32_t used = firstFreeSlot(index);
+  for (uint32_t slot = 0; slot < used; slot++)
+  {
+    Record record;
+    if (readSlot(index, slot, record) && (!found || record.sequence > newest.sequence))
+    {
+      newest = record;
+      found = true;
+    }
+  }
+  return found;
+}
+
+void SettingsStore::scan()
+{
+  active = 0;
+  sequence = 0;
+  for (uint8_t index = 0; index < sectorCount; index++)
+  {
+    Record newest;
+    if (newestIn(index, newest) && newest.sequence > sequence)
+    {
+      active = index;
+      sequence = newest.sequence;
+    }
+  }
+  nextSlot = firstFreeSlot(active);
+  scanned = true;
+}
+
+bool SettingsStore::load(ClockSettings &out)
+{
+  scan();
+
+  Record newest;
+  if (!newestIn(active, newest))
+  {
+    return false;
+  }
+
+  out.dayBrightness = newest.dayBrightness;
+  out.nightBrightness = newest.nightBrightness;
+  out.dayStartMinutes = newest.dayStartMinutes;
+  out.nightStartMinutes = newest.nightStartMinutes;
+  return true;
+}
+
+bool SettingsStore::writeSlot(uint8_t index, uint32_t slot, const uint32_t *words)
+{
+  Record check;
+  return ESP.flashWrite(slotAddress(index, slot), const_cast<uint32_t *>(words), sizeof(Record)) &&
+         readSlot(index, slot, check) && memcmp(&check, words, sizeof(Record)) == 0;
+}
+
+bool SettingsStore::save(const ClockSettings &in)
+{
+  if (!scanned)
+  {
+    scan();
+  }
+
+  uint32_t words[SLOT_SIZE / 4];
+  memset(words, 0xFF, sizeof(words));
+  Record &record = *(Record *)words;
+  record.magic = RECORD_MAGIC;
+  record.version = RECORD_VERSION;
+  record.size = sizeof(Record);
+  record.sequence = sequence + 1;
+  record.dayBrightness = (uint8_t)in.dayBrightness;
+  record.nightBrightness = (uint8_t)in.nightBrightness;
+  record.dayStartMinutes = (uint16_t)in.dayStartMinutes;
+  record.nightStartMinutes = (uint16_t)in.nightStartMinutes;
+  record.reserved = 0xFFFF;
+  record.crc = crc32((const uint8_t *)&record, offsetof(Record, crc));
+
+  if (nextSlot < slotCount)
+  {
+    // Claim the slot even if the write fails, so the next save never
+    // programs over a half-written slot.
+    uint32_t slot = nextSlot++;
+    if (!writeSlot(active, slot, words))
+    {
+      return false;
+    }
+    sequence = record.sequence;
+    return true;
+  }
+
+  if (sectorCount < 2)
+  {
+    // Single sector: start over. The only moment an interrupted save can
+    // lose the previous record, once every slotCount saves.
+    if (!ESP.flashEraseSector(sectors[active]))
+    {
+      return false;
+    }
+    nextSlot = 1;
+    if (!writeSlot(active, 0, words))
+    {
+      return false;
+    }
+    sequence = record.sequence;
+    return true;
+  }
+
+  // Active sector full: move to the other one. It only holds records older
+  // than the newest, so erasing it first is safe; the full sector goes only
+  // once the new record has been read back intact.
+  uint8_t other = active ^ 1;
+  if (!ESP.flashEraseSector(sectors[other]) || !writeSlot(other, 0, words))
+  {
+    return false; // The full sector still holds the newest record
+  }
+  uint8_t previous = active;
+  active = other;
+  nextSlot = 1;
+  sequence = record.sequence;
+  ESP.flashEraseSector(sectors[previous]); // If this fails, the lower sequence loses anyway
+  return true;
+}
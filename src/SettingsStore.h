@@ -0,0 +1,77 @@
+#pragma once
+#include "Arduino.h"
+
+// User-adjustable settings that survive a reboot.
+struct ClockSettings
+{
+  int dayBrightness;
+  int nightBrightness;
+  int dayStartMinutes;   // minutes since midnight (0-1439)
+  int nightStartMinutes; // minutes since midnight (0-1439)
+
+  bool operator==(const ClockSettings &other) const
+  {
+    return dayBrightness == other.dayBrightness && nightBrightness == other.nightBrightness &&
+           dayStartMinutes == other.dayStartMinutes && nightStartMinutes == other.nightStartMinutes;
+  }
+};
+
+// Compact binary settings store in the flash sector reserved for EEPROM
+// emulation and the free sector just below it, read and written directly (no
+// filesystem mount needed).
+//
+// Each sector is a ring of fixed-size record slots. Each save programs the
+// next erased slot with a versioned, CRC-protected record carrying an
+// increasing sequence number, and reads it back; load picks the valid record
+// with the highest sequence across both sectors. A save never overwrites or
+// erases the newest record: once the active sector is full, the next record
+// goes to slot 0 of the other (freshly erased) sector, and the old sector is
+// erased only after that record verifies. Losing power at any point leaves
+// either the new record or the previous one.
+//
+// Flash layouts without a free sector below EEPROM fall back to a single
+// sector, where the erase on wrap-around is the one unprotected moment.
+class SettingsStore
+{
+public:
+  SettingsStore();
+
+  bool load(ClockSettings &out); // false if no valid record exists
+  bool save(const ClockSettings &in);
+
+private:
+  static const uint16_t RECORD_MAGIC = 0x5AC7;
+  static const uint8_t RECORD_VERSION = 1;
+  static const uint32_t SLOT_SIZE = 32;
+
+  struct Record
+  {
+    uint16_t magic;
+    uint8_t version;
+    uint8_t size; // sizeof(Record), lets a later version append fields
+    uint32_t sequence;
+    uint8_t dayBrightness;
+    uint8_t nightBrightness;
+    uint16_t dayStartMinutes;
+    uint16_t nightStartMinutes;
+    uint16_t reserved;
+    uint32_t crc; // CRC-32 of every byte before this field
+  } __attribute__((aligned(4)));
+
+  uint32_t sectors[2];
+  uint8_t sectorCount;
+  uint32_t slotCount;  // Per sector
+  uint8_t active;      // Sector holding the newest record, valid once scanned
+  uint32_t nextSlot;   // First erased slot in the active sector
+  uint32_t sequence;   // Sequence of the newest valid record
+  bool scanned;
+
+  void scan();
+  bool newestIn(uint8_t index, Record &newest);
+  uint32_t firstFreeSlot(uint8_t index);
+  bool writeSlot(uint8_t index, uint32_t slot, const uint32_t *words);
+  uint32_t slotAddress(uint8_t index, uint32_t slot) const;
+  bool readSlot(uint8_t index, uint32_t slot, Record &record);
+  bool slotErased(uint8_t index, uint32_t slot);
+  static uint32_t crc32(const uint8_t *data, size_t length);
+};
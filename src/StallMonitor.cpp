@@ -0,0 +1,151 @@
+#include "StallMonitor.h"
+#include "RtcMemory.h"
+
+// Word offsets of the record inside RTC_BLOCK_STALL_MONITOR
+enum StallRecordWord : uint8_t
+{
+  STALL_RTC_MAGIC,
+  STALL_RTC_ACTIVE_SECTION, // Written by the interrupt while a stall is in progress
+  STALL_RTC_ACTIVE_MS,      // 0 = no stall in progress
+  STALL_RTC_NEAR_MISSES,
+  STALL_RTC_WORST_SECTION,
+  STALL_RTC_WORST_MS,
+  STALL_RTC_MAGIC_CHECK, // ~magic
+  STALL_RTC_WORDS
+};
+static const uint32_t STALL_RTC_MAGIC_VALUE = 0x57A11ED0UL;
+
+static const char *const STALL_SECTION_NAMES[STALL_SECTION_COUNT] = {
+    "loop", "setup", "wifi_check", "time_sync", "mqtt", "mqtt_reconnect",
+    "notification", "settings_save", "ota", "ota_end", "web", "wifi_portal", "ota_transfer"};
+
+// Timer1 counts the 80 MHz APB clock (independent of the CPU frequency).
+static const uint32_t STALL_TIMER_TICKS = (80000000UL / 256 / 1000) * STALL_TICK_MS;
+
+volatile StallSection StallMonitor::current = STALL_SETUP;
+volatile uint32_t StallMonitor::ticks = 0;
+uint32_t StallMonitor::nearMisses = 0;
+String StallMonitor::resetReason;
+uint32_t StallMonitor::lastStallSection = STALL_LOOP;
+uint32_t StallMonitor::lastStallMs = 0;
+uint32_t StallMonitor::lastNearMisses = 0;
+uint32_t StallMonitor::lastWorstSection = STALL_LOOP;
+uint32_t StallMonitor::lastWorstMs = 0;
+static bool started = false;
+
+void StallMonitor::begin()
+{
+  volatile uint32_t *rtc = rtcUserMemory(RTC_BLOCK_STALL_MONITOR);
+  const rst_info *info = ESP.getResetInfoPtr();
+  resetReason = ESP.getResetReason();
+
+  // RTC memory is random after a power cut; only trust it across a reset.
+  bool valid = info->reason != REASON_DEFAULT_RST && rtc[STALL_RTC_MAGIC] == STALL_RTC_MAGIC_VALUE &&
+               rtc[STALL_RTC_MAGIC_CHECK] == ~STALL_RTC_MAGIC_VALUE;
+  if (valid)
+  {
+    lastStallSection = rtc[STALL_RTC_ACTIVE_SECTION];
+    lastStallMs = rtc[STALL_RTC_ACTIVE_MS];
+    lastNearMisses = rtc[STALL_RTC_NEAR_MISSES];
+    lastWorstSection = rtc[STALL_RTC_WORST_SECTION];
+    lastWorstMs = rtc[STALL_RTC_WORST_MS];
+  }
+
+  if (lastStallMs > 0)
+  {
+    Serial.println("Previous boot ended " + String(lastStallMs) + " ms into a stall in " +
+                   sectionName(lastStallSection) + " (" + resetReason + ")");
+  }
+
+  for (uint32_t i = 0; i < STALL_RTC_WORDS; i++)
+  {
+    rtc[i] = 0;
+  }
+  rtc[STALL_RTC_MAGIC] = STALL_RTC_MAGIC_VALUE;
+  rtc[STALL_RTC_MAGIC_CHECK] = ~STALL_RTC_MAGIC_VALUE;
+
+  ticks = 0;
+  timer1_attachInterrupt(onTimer);
+  timer1_enable(TIM_DIV256, TIM_EDGE, TIM_LOOP);
+  timer1_write(STALL_TIMER_TICKS);
+  started = true;
+}
+
+void IRAM_ATTR StallMonitor::onTimer()
+{
+  uint32_t elapsed = ++ticks * STALL_TICK_MS;
+  if (elapsed >= STALL_NEAR_MISS_MS)
+  {
+    // Plain word writes: safe from an interrupt, and already in place if the
+    // watchdog resets the chip before feed() runs again.
+    volatile uint32_t *rtc = rtcUserMemory(RTC_BLOCK_STALL_MONITOR);
+    rtc[STALL_RTC_ACTIVE_SECTION] = current;
+    rtc[STALL_RTC_ACTIVE_MS] = elapsed;
+  }
+}
+
+void StallMonitor::feed()
+{
+  if (!started)
+  {
+    return;
+  }
+
+  volatile uint32_t *rtc = rtcUserMemory(RTC_BLOCK_STALL_MONITOR);
+  noInterrupts();
+  ticks = 0;
+  uint32_t stalledMs = rtc[STALL_RTC_ACTIVE_MS];
+  uint32_t section = rtc[STALL_RTC_ACTIVE_SECTION];
+  rtc[STALL_RTC_ACTIVE_MS] = 0;
+  interrupts();
+
+  if (stalledMs == 0)
+  {
+    return;
+  }
+  if (section >= STALL_WIFI_PORTAL && section < STALL_SECTION_COUNT)
+  {
+    Serial.println("Blocked " + String(stalledMs) + " ms in " + sectionName(section) + " (expected)");
+    return;
+  }
+
+  nearMisses++;
+  rtc[STALL_RTC_NEAR_MISSES] = rtc[STALL_RTC_NEAR_MISSES] + 1;
+  if (stalledMs > rtc[STALL_RTC_WORST_MS])
+  {
+    rtc[STALL_RTC_WORST_MS] = stalledMs;
+    rtc[STALL_RTC_WORST_SECTION] = section;
+  }
+  Serial.println("Watchdog near miss: " + String(stalledMs) + " ms in " + sectionName(section));
+}
+
+StallSection StallMonitor::enter(StallSection section)
+{
+  StallSection previous = current;
+  current = section;
+  return previous;
+}
+
+const char *StallMonitor::sectionName(uint32_t section)
+{
+  return section < STALL_SECTION_COUNT ? STALL_SECTION_NAMES[section] : "unknown";
+}
+
+String StallMonitor::bootReportJson()
+{
+  String json = "{\"reset_reason\":\"" + resetReason + "\",";
+  if (lastStallMs > 0)
+  {
+    // The reset (usually the watchdog) hit during a stall in progress.
+    json += "\"stall_section\":\"" + String(sectionName(lastStallSection)) + "\",";
+    json += "\"stall_ms\":" + String(lastStallMs) + ",";
+  }
+  json += "\"near_misses\":" + String(lastNearMisses);
+  if (lastNearMisses > 0)
+  {
+    json += ",\"worst_section\":\"" + String(sectionName(lastWorstSection)) + "\",";
+    json += "\"worst_ms\":" + String(lastWorstMs);
+  }
+  json += "}";
+  return json;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include "Arduino.h"
+
+// Stall monitor tuning
+const uint32_t STALL_TICK_MS = 50;         // Timer interrupt period
+const uint32_t STALL_NEAR_MISS_MS = 2000;  // Longer than this without a check-in is a near miss
+                                           // (the SDK's soft watchdog bites at ~3 s)
+
+// What the firmware was doing. Tagged around the calls that are known to
+// block; STALL_LOOP covers everything else. The sections from
+// STALL_WIFI_PORTAL on block on purpose (waiting for a user or a whole
+// firmware image): a stall there is still recorded in case the watchdog
+// fires, but it is not counted as a near miss.
+enum StallSection : uint8_t
+{
+  STALL_LOOP,
+  STALL_SETUP,
+  STALL_WIFI_CHECK,
+  STALL_TIME_SYNC,
+  STALL_MQTT,
+  STALL_MQTT_RECONNECT,
+  STALL_NOTIFICATION,
+  STALL_SETTINGS_SAVE,
+  STALL_OTA,
+  STALL_OTA_END,
+  STALL_WEB,
+  STALL_WIFI_PORTAL,  // WiFiManager autoConnect() and its config portal
+  STALL_OTA_TRANSFER, // ArduinoOTA receiving an image, onStart() to onEnd()
+  STALL_SECTION_COUNT
+};
+
+// Software stall detector. A timer1 interrupt counts how long the firmware
+// has gone without checking in (feed(), called wherever the watchdog is fed:
+// the main loop and serviceBackground()). Once that exceeds
+// STALL_NEAR_MISS_MS, the interrupt writes the current section tag and the
+// stall duration straight into RTC memory.
+//
+// feed() counts a finished stall as a near miss. If the watchdog fires
+// first, the record survives the reset. On the next boot begin() turns both
+// into a report, which MQTTManager publishes once on the diagnostics topic.
+//
+// Timer1 is also used by analogWrite()/tone(); this firmware uses neither.
+class StallMonitor
+{
+public:
+  static void begin(); // Read last boot's record, then arm the timer
+  static void feed();
+
+  static StallSection enter(StallSection section); // Returns the previous tag
+  static void leave(StallSection previous) { current = previous; }
+
+  static uint32_t getNearMisses() { return nearMisses; } // This boot
+
+  // {"reset_reason":..,"stall_section":..,"stall_ms":..,"near_misses":..,
+  //  "worst_section":..,"worst_ms":..} describing the previous boot.
+  static String bootReportJson();
+
+private:
+  static volatile StallSection current;
+  static volatile uint32_t ticks;
+  static uint32_t nearMisses;
+
+  // Snapshot of the previous boot, taken in begin()
+  static String resetReason;
+  static uint32_t lastStallSection;
+  static uint32_t lastStallMs;
+  static uint32_t lastNearMisses;
+  static uint32_t lastWorstSection;
+  static uint32_t lastWorstMs;
+
+  static void onTimer();
+  static const char *sectionName(uint32_t section);
+};
+
+// Tags the enclosing scope with a section for the stall monitor.
+class StallScope
+{
+public:
+  explicit StallScope(StallSection section) : previous(StallMonitor::enter(section)) {}
+  ~StallScope() { StallMonitor::leave(previous); }
+
+private:
+  StallSection previous;
+};
+#define STALL_SECTION(section) StallScope stallScope_(section)
@@ -0,0 +1,197 @@
+#include "TextEncoding.h"
+
+// U+00A0-U+00FF. Letters without a CP437 glyph fall back to the base letter.
+static const uint8_t LATIN1_TO_CP437[96] PROGMEM = {
+    ' ', 0xAD, 0x9B, 0x9C, '?', 0x9D, '|', 0x15, '"', 'c', 0xA6, 0xAE, 0xAA, '-', 'r', '-',  // A0  ¡¢£¤¥¦§¨©ª«¬ ®¯
+    0xF8, 0xF1, 0xFD, '3', '\'', 0xE6, 0x14, 0xFA, ',', '1', 0xA7, 0xAF, 0xAC, 0xAB, '?', 0xA8, // °±²³´µ¶·¸¹º»¼½¾¿
+    'A', 'A', 'A', 'A', 0x8E, 0x8F, 0x92, 0x80, 'E', 0x90, 'E', 'E', 'I', 'I', 'I', 'I',         // ÀÁÂÃÄÅÆÇÈÉÊËÌÍÎÏ
+    'D', 0xA5, 'O', GLYPH_O_ACUTE_UPPER, 'O', 'O', 0x99, 'x', 'O', 'U', 'U', 'U', 0x9A, 'Y', 'P', 0xE1, // ÐÑÒÓÔÕÖ×ØÙÚÛÜÝÞß
+    0x85, 0xA0, 0x83, 'a', 0x84, 0x86, 0x91, 0x87, 0x8A, 0x82, 0x88, 0x89, 0x8D, 0xA1, 0x8C, 0x8B, // àáâãäåæçèéêëìíîï
+    'd', 0xA4, 0x95, 0xA2, 0x93, 'o', 0x94, 0xF6, 'o', 0x97, 0xA3, 0x96, 0x81, 'y', 'p', 0x98};    // ðñòóôõö÷øùúûüýþÿ
+
+// U+0100-U+017F. Polish letters use the extended glyphs, the rest the base
+// letter.
+static const uint8_t LATIN_EXT_A_TO_CP437[128] PROGMEM = {
+    'A', 'a', 'A', 'a', GLYPH_A_OGONEK_UPPER, GLYPH_A_OGONEK, GLYPH_C_ACUTE_UPPER, GLYPH_C_ACUTE, // 0100 ĀāĂăĄąĆć
+    'C', 'c', 'C', 'c', 'C', 'c', 'D', 'd',                                                     // 0108 ĈĉĊċČčĎď
+    'D', 'd', 'E', 'e', 'E', 'e', 'E', 'e',                                                     // 0110 ĐđĒēĔĕĖė
+    GLYPH_E_OGONEK_UPPER, GLYPH_E_OGONEK, 'E', 'e', 'G', 'g', 'G', 'g',                         // 0118 ĘęĚěĜĝĞğ
+    'G', 'g', 'G', 'g', 'H', 'h', 'H', 'h',                                                     // 0120 ĠġĢģĤĥĦħ
+    'I', 'i', 'I', 'i', 'I', 'i', 'I', 'i',                                                     // 0128 ĨĩĪīĬĭĮį
+    'I', 'i', 'J', 'j', 'J', 'j', 'K', 'k',                                                     // 0130 İıĲĳĴĵĶķ
+    'k', 'L', 'l', 'L', 'l', 'L', 'l', 'L',                                                     // 0138 ĸĹĺĻļĽľĿ
+    'l', GLYPH_L_STROKE_UPPER, GLYPH_L_STROKE, GLYPH_N_ACUTE_UPPER, GLYPH_N_ACUTE, 'N', 'n', 'N', // 0140 ŀŁłŃńŅņŇ
+    'n', 'n', 'N', 'n', 'O', 'o', 'O', 'o',                                                     // 0148 ňŉŊŋŌōŎŏ
+    'O', 'o', 'O', 'o', 'R', 'r', 'R', 'r',                                                     // 0150 ŐőŒœŔŕŖŗ
+    'R', 'r', GLYPH_S_ACUTE_UPPER, GLYPH_S_ACUTE, 'S', 's', 'S', 's',                           // 0158 ŘřŚśŜŝŞş
+    'S', 's', 'T', 't', 'T', 't', 'T', 't',                                                     // 0160 ŠšŢţŤťŦŧ
+    'U', 'u', 'U', 'u', 'U', 'u', 'U', 'u',                                                     // 0168 ŨũŪūŬŭŮů
+    'U', 'u', 'U', 'u', 'W', 'w', 'Y', 'y',                                                     // 0170 ŰűŲųŴŵŶŷ
+    'Y', GLYPH_Z_ACUTE_UPPER, GLYPH_Z_ACUTE, GLYPH_Z_DOT_UPPER, GLYPH_Z_DOT, 'Z', 'z', 's'};      // 0178 ŸŹźŻżŽžſ
+
+// Other code points with a CP437 glyph (or an obvious ASCII stand-in),
+// sorted by code point for the binary search.
+struct SymbolMapping
+{
+  uint16_t codePoint;
+  uint8_t glyph;
+};
+
+static const SymbolMapping SYMBOLS[] PROGMEM = {
+    {0x0192, 0x9F}, // ƒ
+    {0x0393, 0xE2}, // Γ
+    {0x0398, 0xE9}, // Θ
+    {0x03A3, 0xE4}, // Σ
+    {0x03A6, 0xE8}, // Φ
+    {0x03A9, 0xEA}, // Ω
+    {0x03B1, 0xE0}, // α
+    {0x03B2, 0xE1}, // β
+    {0x03B4, 0xEB}, // δ
+    {0x03B5, 0xEE}, // ε
+    {0x03BC, 0xE6}, // μ
+    {0x03C0, 0xE3}, // π
+    {0x03C3, 0xE5}, // σ
+    {0x03C4, 0xE7}, // τ
+    {0x03C6, 0xED}, // φ
+    {0x2013, '-'},  // en dash
+    {0x2014, '-'},  // em dash
+    {0x2018, '\''}, // ‘
+    {0x2019, '\''}, // ’
+    {0x201A, ','},  // ‚
+    {0x201C, '"'},  // “
+    {0x201D, '"'},  // ”
+    {0x201E, '"'},  // „ (Polish opening quote)
+    {0x2022, 0xF9}, // •
+    {0x2026, '.'},  // …
+    {0x207F, 0xFC}, // ⁿ
+    {0x20A7, 0x9E}, // ₧
+    {0x2219, 0xF9}, // ∙
+    {0x221A, 0xFB}, // √
+    {0x221E, 0xEC}, // ∞
+    {0x2229, 0xEF}, // ∩
+    {0x2248, 0xF7}, // ≈
+    {0x2261, 0xF0}, // ≡
+    {0x2264, 0xF3}, // ≤
+    {0x2265, 0xF2}, // ≥
+    {0x2320, 0xF4}, // ⌠
+    {0x2321, 0xF5}, // ⌡
+    {0x2588, 0xDB}, // █
+    {0x2591, 0xB0}, // ░
+    {0x2592, 0xB1}, // ▒
+    {0x2593, 0xB2}, // ▓
+    {0x25A0, 0xFE}, // ■
+};
+
+static uint8_t lookupSymbol(uint32_t codePoint)
+{
+  int low = 0;
+  int high = (int)(sizeof(SYMBOLS) / sizeof(SYMBOLS[0])) - 1;
+  while (low <= high)
+  {
+    int mid = (low + high) / 2;
+    uint16_t key = pgm_read_word(&SYMBOLS[mid].codePoint);
+    if (key == codePoint)
+    {
+      return pgm_read_byte(&SYMBOLS[mid].glyph);
+    }
+    if (key < codePoint)
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid - 1;
+    }
+  }
+  return '?';
+}
+
+static uint8_t mapCodePoint(uint32_t codePoint)
+{
+  if (codePoint < 0x20)
+  {
+    return ' '; // Control characters (newlines, tabs); keeps the extended range free
+  }
+  if (codePoint < 0x7F)
+  {
+    return (uint8_t)codePoint;
+  }
+  if (codePoint < 0xA0)
+  {
+    return '?'; // DEL and C1 controls
+  }
+  if (codePoint < 0x100)
+  {
+    return pgm_read_byte(&LATIN1_TO_CP437[codePoint - 0xA0]);
+  }
+  if (codePoint < 0x180)
+  {
+    return pgm_read_byte(&LATIN_EXT_A_TO_CP437[codePoint - 0x100]);
+  }
+  if (codePoint > 0xFFFF)
+  {
+    return '?';
+  }
+  return lookupSymbol(codePoint);
+}
+
+// Length of the well-formed UTF-8 sequence at in[0], with its code point, or
+// 0 if it is malformed, truncated, overlong or a surrogate.
+static size_t decodeSequence(const uint8_t *in, size_t available, uint32_t *codePoint)
+{
+  uint8_t lead = in[0];
+  size_t length = (lead >= 0xC2 && lead <= 0xDF)   ? 2
+                  : (lead >= 0xE0 && lead <= 0xEF) ? 3
+                  : (lead >= 0xF0 && lead <= 0xF4) ? 4
+                                                   : 0;
+  if (length == 0 || length > available)
+  {
+    return 0;
+  }
+
+  uint32_t value = lead & (0x7F >> length);
+  for (size_t i = 1; i < length; i++)
+  {
+    if ((in[i] & 0xC0) != 0x80)
+    {
+      return 0;
+    }
+    value = (value << 6) | (in[i] & 0x3F);
+  }
+
+  if ((length == 3 && (value < 0x800 || (value >= 0xD800 && value <= 0xDFFF))) ||
+      (length == 4 && (value < 0x10000 || value > 0x10FFFF)))
+  {
+    return 0;
+  }
+  *codePoint = value;
+  return length;
+}
+
+size_t utf8ToCp437(const char *in, size_t inLength, char *out, size_t outSize, size_t *consumed)
+{
+  const uint8_t *bytes = (const uint8_t *)in;
+  size_t read = 0;
+  size_t written = 0;
+
+  while (read < inLength && written < outSize)
+  {
+    uint8_t c = bytes[read];
+    uint32_t codePoint = c;
+    size_t length = 1;
+    if (c >= 0x80)
+    {
+      length = decodeSequence(bytes + read, inLength - read, &codePoint);
+      if (length == 0)
+      {
+        codePoint = c; // Not UTF-8: take the byte as Latin-1
+        length = 1;
+      }
+    }
+    out[written++] = (char)mapCodePoint(codePoint);
+    read += length;
+  }
+
+  *consumed = read;
+  return written;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "Arduino.h"
+
+// Display encoding: single bytes indexing the CP437 LED font, except for
+// the range below, which the font's control-picture glyphs would otherwise
+// occupy and which DisplayFont draws from its own atlas instead. Input
+// control characters never reach the display (they become spaces), so these
+// codes are free.
+const uint8_t GLYPH_EXT_FIRST = 0x01;
+const uint8_t GLYPH_EXT_COUNT = 17; // Polish letters CP437 lacks
+
+enum ExtendedGlyph : uint8_t
+{
+  GLYPH_A_OGONEK_UPPER = GLYPH_EXT_FIRST, // Ą
+  GLYPH_A_OGONEK,                         // ą
+  GLYPH_C_ACUTE_UPPER,                    // Ć
+  GLYPH_C_ACUTE,                          // ć
+  GLYPH_E_OGONEK_UPPER,                   // Ę
+  GLYPH_E_OGONEK,                         // ę
+  GLYPH_L_STROKE_UPPER,                   // Ł
+  GLYPH_L_STROKE,                         // ł
+  GLYPH_N_ACUTE_UPPER,                    // Ń
+  GLYPH_N_ACUTE,                          // ń
+  GLYPH_O_ACUTE_UPPER,                    // Ó (ó is CP437 0xA2)
+  GLYPH_S_ACUTE_UPPER,                    // Ś
+  GLYPH_S_ACUTE,                          // ś
+  GLYPH_Z_ACUTE_UPPER,                    // Ź
+  GLYPH_Z_ACUTE,                          // ź
+  GLYPH_Z_DOT_UPPER,                      // Ż
+  GLYPH_Z_DOT                             // ż
+};
+
+// Decode UTF-8 into the display encoding in a single pass. Latin-1 and Latin
+// Extended-A are covered in full: exact CP437 glyphs where the font has
+// them, the extended set for Polish, otherwise the unaccented base letter.
+// A few common symbols (Greek, math, typographic quotes and dashes) map to
+// their CP437 glyphs; anything else becomes '?'. Malformed bytes are read as
+// Latin-1, so un-encoded 8-bit input still shows up sensibly.
+//
+// Writes at most outSize bytes and stops before a sequence it cannot fit;
+// *consumed is set to the input bytes used. The output is never longer than
+// the input, so an outSize >= inLength always consumes everything.
+size_t utf8ToCp437(const char *in, size_t inLength, char *out, size_t outSize, size_t *consumed);
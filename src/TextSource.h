@@ -0,0 +1,25 @@
+#pragma once
+#include "Arduino.h"
+
+// Read-only, random-access view of display-encoded (CP437) text. The scroll
+// engine only ever asks for the few characters around the visible window, so
+// a source can stream its bytes from flash instead of holding them in a String.
+class TextSource
+{
+public:
+  virtual ~TextSource() {}
+  virtual unsigned int length() = 0;
+  virtual char charAt(unsigned int index) = 0; // index < length()
+};
+
+// Adapter for text that already lives in RAM.
+class StringTextSource : public TextSource
+{
+public:
+  explicit StringTextSource(const String &textRef) : text(textRef) {}
+  unsigned int length() override { return text.length(); }
+  char charAt(unsigned int index) override { return text[index]; }
+
+private:
+  const String &text;
+};
@@ -0,0 +1,282 @@
+#include "TextStore.h"
+#include "DisplayManager.h"
+
+TextStore::TextStore() : filesystemAvailable(false)
+{
+}
+
+void TextStore::begin(bool fsAvailable)
+{
+  filesystemAvailable = fsAvailable;
+  if (!filesystemAvailable)
+  {
+    return;
+  }
+
+  // Texts never survive a reboot (the queue that referenced them is gone).
+  for (int i = 0; i < TEXT_STORE_SLOTS; i++)
+  {
+    String path = pathFor(i);
+    if (LittleFS.exists(path))
+    {
+      LittleFS.remove(path);
+    }
+  }
+}
+
+String TextStore::pathFor(int slot)
+{
+  return "/text_" + String(slot) + ".txt";
+}
+
+int TextStore::findUpload(const String &id) const
+{
+  for (int i = 0; i < TEXT_STORE_SLOTS; i++)
+  {
+    if (slots[i].used && !slots[i].complete && slots[i].id == id)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int TextStore::allocate(const String &id)
+{
+  for (int i = 0; i < TEXT_STORE_SLOTS; i++)
+  {
+    if (!slots[i].used)
+    {
+      slots[i] = Slot();
+      slots[i].used = true;
+      slots[i].id = id;
+      return i;
+    }
+  }
+  return -1;
+}
+
+void TextStore::expireStaleUploads()
+{
+  unsigned long now = millis();
+  for (int i = 0; i < TEXT_STORE_SLOTS; i++)
+  {
+    if (slots[i].used && !slots[i].complete && now - slots[i].lastChunkMs > TEXT_STORE_UPLOAD_TIMEOUT_MS)
+    {
+      Serial.println("Text upload '" + slots[i].id + "' timed out, dropping it");
+      release(i);
+    }
+  }
+}
+
+int TextStore::append(const String &id, int seq, const String &utf8Text, bool final)
+{
+  expireStaleUploads();
+
+  int index = findUpload(id);
+  if (seq == 0)
+  {
+    // A new first chunk restarts an upload with the same id.
+    if (index >= 0)
+    {
+      release(index);
+    }
+    index = allocate(id);
+    if (index < 0)
+    {
+      Serial.println("Text store full, rejecting upload '" + id + "'");
+      return -1;
+    }
+  }
+  else if (index < 0)
+  {
+    Serial.println("Chunk " + String(seq) + " for unknown upload '" + id + "'");
+    return -1;
+  }
+
+  Slot &slot = slots[index];
+  if (seq < slot.nextSeq)
+  {
+    return -1; // Duplicate delivery, already stored
+  }
+  if (seq > slot.nextSeq)
+  {
+    Serial.println("Upload '" + id + "' missed chunk " + String(slot.nextSeq) + ", dropping it");
+    release(index);
+    return -1;
+  }
+
+  // Prepend bytes held back from the previous chunk, then hold back a UTF-8
+  // sequence that is cut off at the end of this one (unless it is the last).
+  String data;
+  data.reserve(slot.carryLength + utf8Text.length());
+  for (uint8_t i = 0; i < slot.carryLength; i++)
+  {
+    data += slot.carry[i];
+  }
+  data += utf8Text;
+  slot.carryLength = 0;
+
+  if (!final)
+  {
+    int end = data.length();
+    for (int back = 1; back <= 3 && back <= end; back++)
+    {
+      unsigned char c = (unsigned char)data[end - back];
+      if ((c & 0xC0) == 0x80)
+      {
+        continue; // Continuation byte, keep looking for the lead byte
+      }
+      int needed = (c >= 0xF0) ? 4 : (c >= 0xE0) ? 3 : (c >= 0xC0) ? 2 : 1;
+      if (needed > back)
+      {
+        for (int i = 0; i < back; i++)
+        {
+          slot.carry[i] = data[end - back + i];
+        }
+        slot.carryLength = back;
+        data.remove(end - back);
+      }
+      break;
+    }
+  }
+
+  if (!store(slot, index, DisplayManager::sanitizeText(data)))
+  {
+    release(index);
+    return -1;
+  }
+
+  slot.nextSeq++;
+  slot.lastChunkMs = millis();
+
+  if (!final)
+  {
+    return -1;
+  }
+
+  slot.complete = true;
+  Serial.println("Text upload '" + id + "' complete: " + String(slot.length) + " bytes" +
+                 (slot.onDisk ? " (LittleFS)" : " (RAM)"));
+  return index;
+}
+
+bool TextStore::store(Slot &slot, int index, const String &encoded)
+{
+  if (slot.length + encoded.length() > TEXT_STORE_MAX_LENGTH)
+  {
+    Serial.println("Upload '" + slot.id + "' exceeds " + String(TEXT_STORE_MAX_LENGTH) + " bytes, dropping it");
+    return false;
+  }
+
+  // Spill to LittleFS once the text outgrows the RAM budget or the heap is
+  // getting tight. Without a filesystem, RAM is all there is.
+  if (!slot.onDisk && filesystemAvailable &&
+      (slot.length + encoded.length() > TEXT_STORE_RAM_LIMIT || ESP.getFreeHeap() < TEXT_STORE_MIN_FREE_HEAP))
+  {
+    File file = LittleFS.open(pathFor(index), "w");
+    if (!file)
+    {
+      Serial.println("Failed to open text store file");
+      return false;
+    }
+    file.print(slot.ram);
+    file.close();
+    slot.ram = String();
+    slot.onDisk = true;
+  }
+
+  if (slot.onDisk)
+  {
+    File file = LittleFS.open(pathFor(index), "a");
+    if (!file || file.print(encoded) != encoded.length())
+    {
+      Serial.println("Failed to append to text store file");
+      return false;
+    }
+    file.close();
+  }
+  else
+  {
+    slot.ram += encoded;
+  }
+
+  slot.length += encoded.length();
+  return true;
+}
+
+void TextStore::release(int slot)
+{
+  if (slot < 0 || slot >= TEXT_STORE_SLOTS || !slots[slot].used)
+  {
+    return;
+  }
+  if (slots[slot].onDisk)
+  {
+    LittleFS.remove(pathFor(slot));
+  }
+  slots[slot] = Slot();
+}
+
+bool TextStore::isComplete(int slot) const
+{
+  return slot >= 0 && slot < TEXT_STORE_SLOTS && slots[slot].used && slots[slot].complete;
+}
+
+unsigned int TextStore::length(int slot) const
+{
+  return isComplete(slot) ? slots[slot].length : 0;
+}
+
+StoredText::StoredText(TextStore &storeRef, int slotIndex)
+    : store(storeRef), slot(slotIndex), windowStart(0), windowLength(0)
+{
+  if (store.isComplete(slot) && store.slots[slot].onDisk)
+  {
+    file = LittleFS.open(TextStore::pathFor(slot), "r");
+  }
+}
+
+StoredText::~StoredText()
+{
+  if (file)
+  {
+    file.close();
+  }
+}
+
+unsigned int StoredText::length()
+{
+  return store.length(slot);
+}
+
+char StoredText::charAt(unsigned int index)
+{
+  if (index >= length())
+  {
+    return ' ';
+  }
+
+  const TextStore::Slot &stored = store.slots[slot];
+  if (!stored.onDisk)
+  {
+    return stored.ram[index];
+  }
+
+  // Refill the window so it starts a little before `index`: the scroll
+  // engine walks backwards from the rightmost visible character.
+  if (index < windowStart || index >= windowStart + windowLength)
+  {
+    windowStart = (index > WINDOW_SIZE / 2) ? index - WINDOW_SIZE / 2 : 0;
+    windowLength = 0;
+    if (file && file.seek(windowStart))
+    {
+      windowLength = file.read((uint8_t *)window, WINDOW_SIZE);
+    }
+    if (index < windowStart || index >= windowStart + windowLength)
+    {
+      return ' '; // Read failed; blank rather than garbage
+    }
+  }
+  return window[index - windowStart];
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "Arduino.h"
+#include <LittleFS.h>
+#include "TextSource.h"
+
+// Text store limits
+const int TEXT_STORE_SLOTS = 4;                             // Uploads in flight + completed texts waiting in the queue
+const unsigned int TEXT_STORE_MAX_LENGTH = 8192;            // Max stored length of one text (bytes, after encoding)
+const unsigned int TEXT_STORE_RAM_LIMIT = 1536;             // Texts longer than this spill to LittleFS
+const uint32_t TEXT_STORE_MIN_FREE_HEAP = 16384;            // Spill to LittleFS early if the heap drops below this
+const unsigned long TEXT_STORE_UPLOAD_TIMEOUT_MS = 60000UL; // Drop an upload whose next chunk never arrives
+
+// Holds notification texts too long for a single MQTT packet. A text arrives
+// as numbered chunks under an upload id; each chunk is converted to the
+// display's CP437 encoding as it lands and appended to the slot, in RAM for
+// short texts or in a LittleFS file once the text (or the heap) gets tight.
+// A completed slot is read back through StoredText, which only ever keeps a
+// small window of the text in memory.
+class TextStore
+{
+public:
+  TextStore();
+
+  void begin(bool filesystemAvailable); // Also clears files left over from before a reboot
+
+  // Append chunk `seq` (0-based) of upload `id`. Returns the slot index once
+  // the final chunk completed the text, -1 while incomplete or on error (an
+  // out-of-order chunk aborts the upload; a repeated chunk is ignored).
+  int append(const String &id, int seq, const String &utf8Text, bool final);
+  void release(int slot); // Free a completed text once it has been shown
+
+  bool isComplete(int slot) const;
+  unsigned int length(int slot) const;
+
+private:
+  friend class StoredText;
+
+  struct Slot
+  {
+    bool used = false;
+    bool complete = false;
+    bool onDisk = false;
+    String id;
+    int nextSeq = 0;
+    unsigned int length = 0;
+    String ram;                 // Encoded text while it is held in RAM
+    unsigned long lastChunkMs = 0;
+    char carry[4];              // Trailing bytes of a UTF-8 sequence split across chunks
+    uint8_t carryLength = 0;
+  };
+
+  Slot slots[TEXT_STORE_SLOTS];
+  bool filesystemAvailable;
+
+  int findUpload(const String &id) const;
+  int allocate(const String &id);
+  void expireStaleUploads();
+  bool store(Slot &slot, int index, const String &encoded);
+  static String pathFor(int slot);
+};
+
+// TextSource over a completed TextStore slot. Disk-backed texts are read
+// through a small window cache, so scrolling an 8 KB text costs a few dozen
+// bytes of RAM.
+class StoredText : public TextSource
+{
+public:
+  StoredText(TextStore &storeRef, int slotIndex);
+  ~StoredText();
+
+  unsigned int length() override;
+  char charAt(unsigned int index) override;
+
+private:
+  static const unsigned int WINDOW_SIZE = 64;
+
+  TextStore &store;
+  int slot;
+  File file;
+  char window[WINDOW_SIZE];
+  unsigned int windowStart;
+  unsigned int windowLength;
+};
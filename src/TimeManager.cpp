@@ -1,10 +1,13 @@
 #include "TimeManager.h"
 #include "Settings.h"
+#include "StallMonitor.h"
+#include "CpuFrequency.h"
+#include "RtcMemory.h"
 #include <TimeLib.h>
 
 TimeManager::TimeManager(TimeDB &timeDBRef, DisplayManager &displayRef)
     : timeDB(timeDBRef), display(displayRef), lastMinute("xx"), lastEpoch(0), firstEpoch(0),
-      timeSynced(false), lastSyncAttemptMs(0)
+      timeSynced(false), timeRestored(false)
 {
 }
 
@@ -12,14 +15,16 @@ void TimeManager::updateTime()
 {
   Serial.println("Updating Time...");
 
-  // Record the attempt time up front so failures back off (see shouldUpdateTime)
-  // instead of retrying every loop iteration.
-  lastSyncAttemptMs = millis();
-
   // Show update indicator
   display.showUpdateIndicator();
 
-  time_t currentTime = timeDB.getTime();
+  time_t currentTime;
+  {
+    STALL_SECTION(STALL_TIME_SYNC);
+    CpuBoost boost; // Shorter stall while the response is parsed
+    currentTime = timeDB.getTime();
+  }
+  display.hideUpdateIndicator();
   if (currentTime > 5000)
   {
     setTime(currentTime);
@@ -41,39 +46,55 @@ void TimeManager::updateTime()
   }
 }
 
-String TimeManager::getFormattedTime(bool isRefresh)
+int TimeManager::getMinutesFromLastRefresh()
+{
+  return (now() - lastEpoch) / 60;
+}
+
+unsigned long TimeManager::nextSyncDelayMs() const
 {
+  // Before the first successful sync (e.g. no internet), retry on a short
+  // interval so the clock gets a time soon without hammering the server.
   if (!timeSynced)
   {
-    return "--:--"; // Placeholder until the first successful time sync
+    return TIME_SYNC_RETRY_INTERVAL_MS;
   }
-  return hourMinutes(isRefresh);
-}
 
-int TimeManager::getMinutesFromLastRefresh()
-{
-  return (now() - lastEpoch) / 60;
+  // Once synced, refresh on the normal long interval.
+  return (unsigned long)MINUTES_BETWEEN_DATA_REFRESH * 60000UL;
 }
 
-bool TimeManager::shouldUpdateTime()
-{
-  unsigned long nowMs = millis();
+// RTC_BLOCK_CLOCK record: magic, epoch, ~epoch
+static const uint32_t CLOCK_RTC_MAGIC = 0xC10CC10CUL;
 
-  // Very first attempt right after boot.
-  if (lastSyncAttemptMs == 0)
+void TimeManager::saveToRtc()
+{
+  if (!hasTime())
   {
-    return true;
+    return;
   }
+  uint32_t epoch = now();
+  uint32_t record[3] = {CLOCK_RTC_MAGIC, epoch, ~epoch};
+  ESP.rtcUserMemoryWrite(RTC_BLOCK_CLOCK, record, sizeof(record));
+}
 
-  // Before the first successful sync (e.g. no internet), retry on a short
-  // interval rather than every loop, so the display stays responsive.
-  if (!timeSynced)
+bool TimeManager::restoreFromRtc()
+{
+  uint32_t record[3];
+  if (!ESP.rtcUserMemoryRead(RTC_BLOCK_CLOCK, record, sizeof(record)) || record[0] != CLOCK_RTC_MAGIC ||
+      record[2] != ~record[1])
   {
-    return (nowMs - lastSyncAttemptMs) >= TIME_SYNC_RETRY_INTERVAL_MS;
+    return false;
   }
 
-  // Once synced, refresh on the normal long interval.
-  return (nowMs - lastSyncAttemptMs) >= ((unsigned long)MINUTES_BETWEEN_DATA_REFRESH * 60000UL);
+  // Saved on every clock frame and by prepareForRestart(). After a planned
+  // restart it trails the real time by the reboot itself (well under a
+  // second); after a watchdog reset, by the stall that caused it (up to the
+  // 8 s hardware watchdog). The next sync corrects it.
+  setTime(record[1]);
+  timeRestored = true;
+  Serial.println("Time restored from RTC memory");
+  return true;
 }
 
 bool TimeManager::hasMinuteChanged()
@@ -87,17 +108,7 @@ bool TimeManager::hasMinuteChanged()
   return false;
 }
 
-String TimeManager::secondsIndicator(bool isRefresh)
-{
-  String rtnValue = ":";
-  if (!isRefresh && FLASH_ON_SECONDS && (second() % 2) == 0)
-  {
-    rtnValue = " ";
-  }
-  return rtnValue;
-}
-
-String TimeManager::hourMinutes(bool isRefresh)
+bool TimeManager::isColonVisible(bool isRefresh)
 {
-  return String(hour()) + secondsIndicator(isRefresh) + timeDB.zeroPad(minute());
+  return isRefresh || !FLASH_ON_SECONDS || (second() % 2) != 0;
 }
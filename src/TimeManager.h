@@ -14,20 +14,24 @@ public:
 
   // Time operations
   void updateTime();
-  String getFormattedTime(bool isRefresh = false);
   int getMinutesFromLastRefresh();
-  bool shouldUpdateTime();
+  unsigned long nextSyncDelayMs() const; // When the sync task should run again (ms from now)
   bool hasMinuteChanged();
 
   // Time formatting helpers
-  String secondsIndicator(bool isRefresh);
-  String hourMinutes(bool isRefresh);
+  bool isColonVisible(bool isRefresh = false); // The colon blinks with FLASH_ON_SECONDS
 
   // Getters
   String getLastMinute() const { return lastMinute; }
   long getLastEpoch() const { return lastEpoch; }
   long getFirstEpoch() const { return firstEpoch; }
   bool isTimeSynced() const { return timeSynced; }
+  bool hasTime() const { return timeSynced || timeRestored; } // Synced, or restored after a warm reset
+
+  // Fast warm boot: the current time is kept in RTC memory (survives a reset,
+  // not a power cut) and restored before the first sync.
+  void saveToRtc();
+  bool restoreFromRtc();
 
 private:
   TimeDB &timeDB;
@@ -39,6 +43,6 @@ private:
   long firstEpoch;
 
   // Sync state
-  bool timeSynced;                  // true once we have a valid time at least once
-  unsigned long lastSyncAttemptMs;  // millis() of the last sync attempt (for backoff)
+  bool timeSynced;   // true once we have a valid time at least once
+  bool timeRestored; // time came from RTC memory and awaits its first sync
 };
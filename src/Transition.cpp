@@ -0,0 +1,188 @@
+#include "Transition.h"
+
+// Galois LFSR feedback masks with a full period of 2^n - 1, by bit count n.
+static const uint16_t LFSR_TAPS[17] PROGMEM = {
+    0, 0, 0x3, 0x6, 0xC, 0x14, 0x30, 0x60, 0xB8, 0x110, 0x240, 0x500, 0xE08, 0x1C80, 0x3802, 0x6000, 0xD008};
+
+Transition::Transition(FrameLayer &fromRef, FrameLayer &toRef, FrameLayer &outRef)
+    : from(fromRef), to(toRef), out(outRef), revealed(outRef.width(), outRef.height()), effect(TRANSITION_CUT),
+      frame(0), running(false), lfsr(1), lfsrTaps(0), stepsPerFrame(0)
+{
+  rollColumns = new uint32_t[out.words()];
+}
+
+Transition::~Transition()
+{
+  delete[] rollColumns;
+}
+
+void Transition::begin(TransitionEffect newEffect)
+{
+  effect = newEffect;
+  frame = 0;
+  running = (effect != TRANSITION_CUT);
+  if (effect == TRANSITION_SLIDE)
+  {
+    findRollColumns();
+  }
+  else if (effect == TRANSITION_DISSOLVE)
+  {
+    startDissolve();
+  }
+  render();
+}
+
+bool Transition::step()
+{
+  if (!running)
+  {
+    return false;
+  }
+  if (++frame >= TRANSITION_FRAMES)
+  {
+    running = false;
+  }
+  else if (effect == TRANSITION_DISSOLVE)
+  {
+    dissolveStep();
+  }
+  render();
+  return running;
+}
+
+void Transition::render()
+{
+  int16_t width = out.width();
+  int16_t height = out.height();
+  uint8_t words = out.words();
+
+  if (!running)
+  {
+    for (int16_t y = 0; y < height; y++)
+    {
+      memcpy(out.row(y), to.row(y), words * sizeof(uint32_t));
+    }
+    return;
+  }
+
+  switch (effect)
+  {
+  case TRANSITION_WIPE:
+  {
+    int16_t edge = (int32_t)width * frame / TRANSITION_FRAMES;
+    for (uint8_t w = 0; w < words; w++)
+    {
+      uint32_t mask = columnMask(0, edge, w);
+      for (int16_t y = 0; y < height; y++)
+      {
+        out.row(y)[w] = (to.row(y)[w] & mask) | (from.row(y)[w] & ~mask);
+      }
+    }
+    break;
+  }
+  case TRANSITION_SLIDE:
+  {
+    // Rolling columns show the old frame moved up by `offset` rows with the
+    // new one right below it.
+    int16_t offset = (int32_t)height * frame / TRANSITION_FRAMES;
+    for (int16_t y = 0; y < height; y++)
+    {
+      int16_t source = y + offset;
+      const uint32_t *rolled = (source < height) ? from.row(source) : to.row(source - height);
+      for (uint8_t w = 0; w < words; w++)
+      {
+        out.row(y)[w] = (to.row(y)[w] & ~rollColumns[w]) | (rolled[w] & rollColumns[w]);
+      }
+    }
+    break;
+  }
+  default: // TRANSITION_DISSOLVE
+    for (int16_t y = 0; y < height; y++)
+    {
+      for (uint8_t w = 0; w < words; w++)
+      {
+        uint32_t mask = revealed.row(y)[w];
+        out.row(y)[w] = (to.row(y)[w] & mask) | (from.row(y)[w] & ~mask);
+      }
+    }
+    break;
+  }
+}
+
+void Transition::findRollColumns()
+{
+  int16_t width = out.width();
+  int16_t height = out.height();
+  uint8_t words = out.words();
+
+  // A column rolls if it belongs to a run of lit columns (a character, in
+  // either frame) in which anything changed, so each changed character rolls
+  // as a whole and unchanged ones stay put.
+  for (uint8_t w = 0; w < words; w++)
+  {
+    rollColumns[w] = 0;
+  }
+
+  int16_t runStart = 0;
+  bool runChanged = false;
+  for (int16_t x = 0; x <= width; x++)
+  {
+    bool lit = false;
+    if (x < width)
+    {
+      uint32_t bit = 0x80000000UL >> (x & 31);
+      for (int16_t y = 0; y < height; y++)
+      {
+        uint32_t before = from.row(y)[x >> 5] & bit;
+        uint32_t after = to.row(y)[x >> 5] & bit;
+        lit |= (before | after) != 0;
+        runChanged |= before != after;
+      }
+    }
+    if (lit)
+    {
+      continue;
+    }
+    if (runChanged)
+    {
+      for (uint8_t w = 0; w < words; w++)
+      {
+        rollColumns[w] |= columnMask(runStart, x, w);
+      }
+    }
+    runStart = x + 1;
+    runChanged = false;
+  }
+}
+
+void Transition::startDissolve()
+{
+  // Smallest LFSR whose period covers every pixel; states past the last
+  // pixel are skipped.
+  uint32_t pixels = (uint32_t)out.width() * out.height();
+  uint8_t bits = 2;
+  while (bits < 16 && ((1UL << bits) - 1) < pixels)
+  {
+    bits++;
+  }
+  lfsrTaps = pgm_read_word(&LFSR_TAPS[bits]);
+  lfsr = 1;
+  uint32_t period = (1UL << bits) - 1;
+  stepsPerFrame = (period + TRANSITION_FRAMES - 2) / (TRANSITION_FRAMES - 1); // Done by the last frame
+  revealed.fillScreen(0);
+}
+
+void Transition::dissolveStep()
+{
+  int16_t width = out.width();
+  uint32_t pixels = (uint32_t)width * out.height();
+  for (uint16_t i = 0; i < stepsPerFrame; i++)
+  {
+    uint32_t index = lfsr - 1;
+    if (index < pixels)
+    {
+      revealed.drawPixel(index % width, index / width, 1);
+    }
+    lfsr = (lfsr >> 1) ^ ((lfsr & 1) ? lfsrTaps : 0);
+  }
+}
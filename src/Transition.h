@@ -0,0 +1,58 @@
+#pragma once
+#include "Arduino.h"
+#include "FrameLayer.h"
+
+enum TransitionEffect : uint8_t
+{
+  TRANSITION_CUT,     // None: the new frame replaces the old one at once
+  TRANSITION_WIPE,    // The new frame sweeps in from the left
+  TRANSITION_SLIDE,   // Characters that changed roll up, the new ones rising from below
+  TRANSITION_DISSOLVE // The new frame appears pixel by pixel in random order
+};
+
+const uint8_t TRANSITION_FRAMES = 16;
+const unsigned long TRANSITION_FRAME_MS = 25; // 16 frames = 0.4 s
+
+// Blends two frames into an output layer over TRANSITION_FRAMES frames.
+// Every effect is a mask or a row shift applied a row word at a time, so a
+// frame costs a few operations per row word whatever the effect; dissolve
+// also advances its LFSR by a fixed number of steps per frame.
+//
+// `to` may be redrawn while the transition runs (e.g. the clock ticks on);
+// render() then redoes the current frame with it.
+class Transition
+{
+public:
+  Transition(FrameLayer &fromRef, FrameLayer &toRef, FrameLayer &outRef);
+  ~Transition();
+
+  // from and to hold the two frames. Renders the first frame into out.
+  void begin(TransitionEffect effect);
+  // Advance and render the next frame; false once the transition is over
+  // (out then equals to).
+  bool step();
+  void render();
+  void finish() { running = false; }
+  bool isRunning() const { return running; }
+
+private:
+  FrameLayer &from;
+  FrameLayer &to;
+  FrameLayer &out;
+  FrameLayer revealed;    // DISSOLVE: pixels already showing `to`
+  uint32_t *rollColumns;  // SLIDE: columns that roll, per row word
+  TransitionEffect effect;
+  uint8_t frame;
+  bool running;
+
+  uint16_t lfsr;          // DISSOLVE: current state; pixel index + 1
+  uint16_t lfsrTaps;
+  uint16_t stepsPerFrame; // LFSR period / TRANSITION_FRAMES, rounded up
+
+  void findRollColumns();
+  void startDissolve();
+  void dissolveStep();
+
+  Transition(const Transition &) = delete;
+  Transition &operator=(const Transition &) = delete;
+};
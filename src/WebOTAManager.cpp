@@ -1,16 +1,24 @@
 #include "WebOTAManager.h"
 #include "Settings.h"
+#include "MqttTopics.h"
+#include "HeapMonitor.h"
+#include "LoopProfiler.h"
+#include "Animation.h"
 #include <ESP8266WiFi.h>
 
-WebOTAManager::WebOTAManager(DisplayManager &displayRef)
-    : display(displayRef), httpServer(80)
+static const char *const WEB_USERNAME = "admin";
+static const char *const WEB_PASSWORD = "mqtt-clock-web";
+static const char *const ANIMATION_UPLOAD_PATH = "/anim/upload.tmp";
+
+WebOTAManager::WebOTAManager(DisplayManager &displayRef, MQTTManager &mqttRef)
+    : display(displayRef), mqtt(mqttRef), httpServer(80), uploadSize(0)
 {
 }
 
 void WebOTAManager::initialize()
 {
   // Setup HTTP update server
-  httpUpdater.setup(&httpServer, "/update", "admin", "mqtt-clock-web");
+  httpUpdater.setup(&httpServer, "/update", WEB_USERNAME, WEB_PASSWORD);
 
   // Setup web pages
   httpServer.on("/", [this]()
@@ -19,13 +27,22 @@ void WebOTAManager::initialize()
                 { handleStatus(); });
   httpServer.on("/info", [this]()
                 { handleInfo(); });
+  httpServer.on("/metrics", [this]()
+                { handleMetrics(); });
+  httpServer.on("/animations", HTTP_GET, [this]()
+                { handleAnimationList(); });
+  httpServer.on("/animations", HTTP_POST, [this]()
+                { handleAnimationUploadDone(); }, [this]()
+                { handleAnimationUpload(); });
+  httpServer.on("/animations", HTTP_DELETE, [this]()
+                { handleAnimationDelete(); });
 
   httpServer.begin();
 
   Serial.println("Web OTA Server started");
   Serial.println("Update URL: http://" + WiFi.localIP().toString() + "/update");
-  Serial.println("Username: admin");
-  Serial.println("Password: mqtt-clock-web");
+  Serial.println("Username: " + String(WEB_USERNAME));
+  Serial.println("Password: " + String(WEB_PASSWORD));
 }
 
 void WebOTAManager::loop()
@@ -56,7 +73,9 @@ void WebOTAManager::handleInfo()
   json += "\"mac\":\"" + WiFi.macAddress() + "\",";
   json += "\"hostname\":\"" + String(DEVICE_HOSTNAME) + "\",";
   json += "\"uptime\":" + String(millis() / 1000) + ",";
-  json += "\"free_heap\":" + String(ESP.getFreeHeap()) + ",";
+  HeapMonitor::sample();
+  json += "\"free_heap\":" + String(HeapMonitor::getFreeHeap()) + ",";
+  json += "\"heap\":" + HeapMonitor::toJson() + ",";
   json += "\"chip_id\":\"" + String(ESP.getChipId(), HEX) + "\",";
   json += "\"flash_size\":" + String(ESP.getFlashChipSize()) + ",";
   json += "\"sdk_version\":\"" + String(ESP.getSdkVersion()) + "\"";
@@ -65,6 +84,144 @@ void WebOTAManager::handleInfo()
   httpServer.send(200, "application/json", json);
 }
 
+void WebOTAManager::handleMetrics()
+{
+  // Heap telemetry, plus the current loop timing window in profiler builds.
+  String json = "{\"heap\":" + HeapMonitor::toJson();
+#ifdef LOOP_PROFILER
+  json += ",\"loop\":" + LoopProfiler::toJson();
+#endif
+  json += "}";
+
+  httpServer.send(200, "application/json", json);
+}
+
+void WebOTAManager::handleAnimationList()
+{
+  httpServer.send(200, "application/json", AnimationPlayer::namesJson());
+}
+
+void WebOTAManager::handleAnimationUpload()
+{
+  HTTPUpload &upload = httpServer.upload();
+  if (upload.status == UPLOAD_FILE_START)
+  {
+    uploadError = "";
+    uploadSize = 0;
+    if (!httpServer.authenticate(WEB_USERNAME, WEB_PASSWORD))
+    {
+      uploadError = "unauthorized";
+      return;
+    }
+
+    // Named by the "name" argument, else by the file name without ".anim".
+    uploadName = httpServer.hasArg("name") ? httpServer.arg("name") : upload.filename;
+    if (uploadName.endsWith(".anim"))
+    {
+      uploadName.remove(uploadName.length() - 5);
+    }
+    if (!AnimationPlayer::isValidName(uploadName))
+    {
+      uploadError = "name must be 1-24 characters of a-z, 0-9, _ and -";
+      return;
+    }
+    uploadFile = LittleFS.open(ANIMATION_UPLOAD_PATH, "w");
+    if (!uploadFile)
+    {
+      uploadError = "filesystem unavailable";
+    }
+  }
+  else if (upload.status == UPLOAD_FILE_WRITE)
+  {
+    if (!uploadFile)
+    {
+      return;
+    }
+    uploadSize += upload.currentSize;
+    if (uploadSize > ANIMATION_MAX_FILE_SIZE || uploadFile.write(upload.buf, upload.currentSize) != upload.currentSize)
+    {
+      uploadError = uploadSize > ANIMATION_MAX_FILE_SIZE ? "file too large" : "write failed";
+      uploadFile.close();
+      LittleFS.remove(ANIMATION_UPLOAD_PATH);
+    }
+  }
+  else if (upload.status == UPLOAD_FILE_END)
+  {
+    if (!uploadFile)
+    {
+      return;
+    }
+    uploadFile.close();
+
+    // Only keep files that play to the end: decode every frame before
+    // replacing anything.
+    bool valid;
+    {
+      FileAnimationSource source(ANIMATION_UPLOAD_PATH);
+      AnimationPlayer player(source);
+      valid = source.isOpen() && player.validate();
+    }
+    String path = AnimationPlayer::pathFor(uploadName);
+    if (!valid)
+    {
+      uploadError = "not an animation file, or corrupt";
+    }
+    else if ((LittleFS.exists(path) && !LittleFS.remove(path)) || !LittleFS.rename(ANIMATION_UPLOAD_PATH, path))
+    {
+      uploadError = "write failed";
+    }
+    LittleFS.remove(ANIMATION_UPLOAD_PATH);
+  }
+  else if (upload.status == UPLOAD_FILE_ABORTED)
+  {
+    uploadError = "upload aborted";
+    if (uploadFile)
+    {
+      uploadFile.close();
+    }
+    LittleFS.remove(ANIMATION_UPLOAD_PATH);
+  }
+}
+
+void WebOTAManager::handleAnimationUploadDone()
+{
+  if (uploadError == "unauthorized")
+  {
+    httpServer.requestAuthentication();
+  }
+  else if (uploadError.length() > 0 || uploadName.length() == 0)
+  {
+    String error = uploadError.length() > 0 ? uploadError : "no file";
+    httpServer.send(400, "application/json", "{\"error\":\"" + error + "\"}");
+  }
+  else
+  {
+    Serial.println("Animation uploaded: " + uploadName + " (" + String(uploadSize) + " bytes)");
+    httpServer.send(200, "application/json",
+                    "{\"name\":\"" + uploadName + "\",\"bytes\":" + String(uploadSize) + "}");
+    mqtt.publishAnimationSelect();
+  }
+  uploadName = "";
+  uploadError = "";
+}
+
+void WebOTAManager::handleAnimationDelete()
+{
+  if (!httpServer.authenticate(WEB_USERNAME, WEB_PASSWORD))
+  {
+    httpServer.requestAuthentication();
+    return;
+  }
+  String name = httpServer.arg("name");
+  if (!AnimationPlayer::isValidName(name) || !LittleFS.remove(AnimationPlayer::pathFor(name)))
+  {
+    httpServer.send(404, "application/json", "{\"error\":\"no such animation\"}");
+    return;
+  }
+  httpServer.send(200, "application/json", "{\"deleted\":\"" + name + "\"}");
+  mqtt.publishAnimationSelect();
+}
+
 String WebOTAManager::getIndexHTML()
 {
   String html = R"(
@@ -119,19 +276,19 @@ String WebOTAManager::getIndexHTML()
         <div class="card">
             <h3>📋 MQTT Topics</h3>
             <p><strong>Notifications:</strong> <code>)" +
-                MQTT_TOPIC_NOTIFICATION + R"(</code></p>
+                mqttTopic(TOPIC_NOTIFICATION) + R"(</code></p>
             <p><strong>Animation:</strong> <code>)" +
-                MQTT_TOPIC_ANIMATION + R"(</code></p>
+                mqttTopic(TOPIC_ANIMATION) + R"(</code></p>
             <p><strong>Day Brightness:</strong> <code>)" +
-                MQTT_TOPIC_BRIGHTNESS_DAY + R"(</code></p>
+                mqttTopic(TOPIC_BRIGHTNESS_DAY) + R"(</code></p>
             <p><strong>Night Brightness:</strong> <code>)" +
-                MQTT_TOPIC_BRIGHTNESS_NIGHT + R"(</code></p>
+                mqttTopic(TOPIC_BRIGHTNESS_NIGHT) + R"(</code></p>
             <p><strong>Day Start:</strong> <code>)" +
-                MQTT_TOPIC_SCHEDULE_DAY_START + R"(</code></p>
+                mqttTopic(TOPIC_SCHEDULE_DAY_START) + R"(</code></p>
             <p><strong>Night Start:</strong> <code>)" +
-                MQTT_TOPIC_SCHEDULE_NIGHT_START + R"(</code></p>
+                mqttTopic(TOPIC_SCHEDULE_NIGHT_START) + R"(</code></p>
             <p><strong>Status:</strong> <code>)" +
-                MQTT_TOPIC_STATUS + R"(</code></p>
+                mqttTopic(TOPIC_STATUS) + R"(</code></p>
         </div>
     </div>
 </body>
@@ -142,6 +299,8 @@ String WebOTAManager::getIndexHTML()
 
 String WebOTAManager::getStatusHTML()
 {
+  // A fresh sample, so the page agrees with the next MQTT heap report.
+  HeapMonitor::sample();
   String html = R"(
 <!DOCTYPE html>
 <html>
@@ -166,7 +325,25 @@ String WebOTAManager::getStatusHTML()
         <div class="metric">
             <span>Free Heap Memory:</span>
             <span class="value">)" +
-                String(ESP.getFreeHeap()) + R"( bytes</span>
+                String(HeapMonitor::getFreeHeap()) + R"( bytes</span>
+        </div>
+
+        <div class="metric">
+            <span>Largest Free Block:</span>
+            <span class="value">)" +
+                String(HeapMonitor::getMaxFreeBlock()) + R"( bytes</span>
+        </div>
+
+        <div class="metric">
+            <span>Heap Fragmentation:</span>
+            <span class="value">)" +
+                String(HeapMonitor::getFragmentation()) + R"( %</span>
+        </div>
+
+        <div class="metric">
+            <span>Lowest Free Heap:</span>
+            <span class="value">)" +
+                String(HeapMonitor::getMinFreeHeap()) + R"( bytes</span>
         </div>
 
         <div class="metric">
@@ -2,12 +2,14 @@
 #include "Arduino.h"
 #include <ESP8266WebServer.h>
 #include <ESP8266HTTPUpdateServer.h>
+#include <LittleFS.h>
 #include "DisplayManager.h"
+#include "MQTTManager.h"
 
 class WebOTAManager
 {
 public:
-    WebOTAManager(DisplayManager &displayRef);
+    WebOTAManager(DisplayManager &displayRef, MQTTManager &mqttRef);
 
     // Web OTA operations
     void initialize();
@@ -16,6 +18,7 @@ public:
 
 private:
     DisplayManager &display;
+    MQTTManager &mqtt; // Republishes the animation select after uploads and deletes
     ESP8266WebServer httpServer;
     ESP8266HTTPUpdateServer httpUpdater;
 
@@ -23,6 +26,18 @@ private:
     void handleRoot();
     void handleStatus();
     void handleInfo();
+    void handleMetrics();
+
+    // Animation files: GET lists, POST uploads (multipart), DELETE ?name= removes
+    void handleAnimationList();
+    void handleAnimationUpload(); // Streams the upload into LittleFS chunk by chunk
+    void handleAnimationUploadDone();
+    void handleAnimationDelete();
+
+    File uploadFile;
+    String uploadName;
+    String uploadError;
+    size_t uploadSize;
 
     // HTML content
     String getIndexHTML();
@@ -1,5 +1,7 @@
 #include "WiFiSetup.h"
 #include "Settings.h"
+#include "BackgroundService.h"
+#include "StallMonitor.h"
 #include <ESP8266WiFi.h>
 
 // Static member initialization
@@ -12,6 +14,8 @@ WiFiSetup::WiFiSetup(DisplayManager &displayRef) : display(displayRef), reconnec
 
 void WiFiSetup::initialize()
 {
+  // Blocks until connected or the portal times out: not a near miss.
+  STALL_SECTION(STALL_WIFI_PORTAL);
   WiFiManager wifiManager;
   wifiManager.setAPCallback(configModeCallback);
 
@@ -21,9 +25,10 @@ void WiFiSetup::initialize()
   // Kept long (10 min) so an in-progress manual setup isn't cut short.
   wifiManager.setConfigPortalTimeout(WIFI_CONFIG_PORTAL_TIMEOUT_SECONDS);
 
-  if (!wifiManager.autoConnect(WIFI_PORTAL_AP_NAME.c_str()))
+  if (!wifiManager.autoConnect(WIFI_PORTAL_AP_NAME))
   {
     Serial.println("Config portal timed out, rebooting to retry WiFi...");
+    prepareForRestart();
     delay(3000);
     ESP.reset();
     delay(5000);
@@ -31,6 +36,20 @@ void WiFiSetup::initialize()
   Serial.println("WiFi connected successfully");
 }
 
+bool WiFiSetup::beginAsync()
+{
+  // Without stored credentials only the WiFiManager portal can help.
+  if (WiFi.SSID().length() == 0)
+  {
+    return false;
+  }
+
+  WiFi.mode(WIFI_STA);
+  WiFi.begin(); // Stored credentials; association completes in the background
+  Serial.println("Connecting to " + WiFi.SSID() + " in the background");
+  return true;
+}
+
 void WiFiSetup::setHostname(const String &hostname)
 {
   wifi_station_set_hostname(hostname.c_str());
@@ -53,6 +72,7 @@ bool WiFiSetup::checkConnection()
     Serial.println("Max reconnection attempts reached, rebooting...");
     display.fillScreen(LOW);
     display.centerPrint("Reboot");
+    prepareForRestart();
     delay(1000);
     ESP.restart();
     return false;
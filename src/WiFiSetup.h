@@ -14,7 +14,8 @@ public:
   WiFiSetup(DisplayManager &displayRef);
 
   // WiFi setup and management
-  void initialize();
+  void initialize();  // Blocking: WiFiManager autoConnect, config portal if needed
+  bool beginAsync();  // Start joining the stored network in the background; false if none is stored
   void setHostname(const String &hostname);
   bool checkConnection(); // Check and reconnect if needed
   bool isConnected() const;
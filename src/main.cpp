@@ -7,19 +7,33 @@
 #include "OTAManager.h"
 #include "WebOTAManager.h"
 #include "BackgroundService.h"
+#include "HeapMonitor.h"
+#include "LoopProfiler.h"
+#include "StallMonitor.h"
+#include "PowerManager.h"
+#include "BootTimeline.h"
+#include "Scheduler.h"
 #include <Ticker.h>
 
-// Timing constants
-const int LOOP_DELAY_MS = 100;                   // Main loop delay to prevent excessive CPU usage
-const unsigned long WIFI_CHECK_INTERVAL = 30000; // Check WiFi every 30 seconds
+// Task periods (network pump and render periods come from the PowerPolicy)
+const unsigned long BRIGHTNESS_UPDATE_INTERVAL_MS = 1000; // Re-evaluate the day/night brightness
+const unsigned long WIFI_CHECK_INTERVAL = 30000;          // Check WiFi every 30 seconds
+const unsigned long NETWORK_INIT_POLL_MS = 100;           // Poll for background Wi-Fi association
+const unsigned long WIFI_ASYNC_CONNECT_TIMEOUT_MS = 20000; // Then fall back to WiFiManager (portal)
 
 // Global variables
 int refresh = 0; // Used by DisplayManager to signal scroll refresh
 Max72xxPanel matrix = Max72xxPanel(PIN_CS, NUMBER_OF_HORIZONTAL_DISPLAYS, NUMBER_OF_VERTICAL_DISPLAYS);
-unsigned long lastWiFiCheck = 0;
+Scheduler scheduler;
+TaskId networkTask = -1;
+TaskId renderTask = -1;
+TaskId timeSyncTask = -1;
+TaskId networkInitTask = -1;
+unsigned long wifiStartMs = 0;
 
-// Set once setup() has initialized OTA/web/MQTT. Until then serviceBackground()
-// only feeds the watchdog, so boot-time scrolls never touch an unstarted service.
+// Set once Wi-Fi is up and OTA/web have been initialized. Until then the
+// network tasks and serviceBackground() leave the network alone, so the clock
+// can already run while Wi-Fi associates in the background.
 bool servicesReady = false;
 
 // Core components
@@ -29,7 +43,7 @@ WiFiSetup wifiSetup(displayManager);
 TimeManager timeManager(timeDB, displayManager);
 MQTTManager mqttManager(displayManager, timeManager);
 OTAManager otaManager(displayManager);
-WebOTAManager webOtaManager(displayManager);
+WebOTAManager webOtaManager(displayManager, mqttManager);
 
 // Keep background services alive during otherwise-blocking display operations
 // (see BackgroundService.h). Feeding the watchdog is always safe; the network
@@ -37,12 +51,28 @@ WebOTAManager webOtaManager(displayManager);
 void serviceBackground()
 {
   ESP.wdtFeed();
+  StallMonitor::feed();
+  PowerManager::keepAwake(); // Blocking display work: no light sleep
+  displayManager.tickBrightness();
+  displayManager.tickTransition();
   if (!servicesReady)
   {
     return;
   }
-  otaManager.loop();
-  webOtaManager.loop();
+  {
+    PROFILE_SECTION(PROFILE_BG_OTA);
+    STALL_SECTION(STALL_OTA);
+    otaManager.loop();
+  }
+  {
+    PROFILE_SECTION(PROFILE_BG_WEB);
+    STALL_SECTION(STALL_WEB);
+    HEAP_AUDIT_SCOPE(HEAP_WEB);
+    webOtaManager.loop();
+  }
+  PROFILE_SECTION(PROFILE_BG_MQTT);
+  STALL_SECTION(STALL_MQTT);
+  HEAP_AUDIT_SCOPE(HEAP_MQTT);
   mqttManager.keepAlive();
 }
 
@@ -62,81 +92,277 @@ void serviceDelay(unsigned long ms)
   }
 }
 
-void setup()
+void prepareForRestart()
 {
-  Serial.begin(115200);
-  delay(10);
-
-  // Enable hardware watchdog (8 seconds timeout)
-  ESP.wdtEnable(WDTO_8S);
-  Serial.println("Watchdog enabled");
-
-  // Initialize matrix display
-  displayManager.initializeMatrix();
-
-  // Set hostname
-  wifiSetup.setHostname(DEVICE_HOSTNAME);
+  mqttManager.flushSettings();
+  timeManager.saveToRtc(); // The last frame may be long ago after an OTA upload or the portal
+}
 
-  // Brightness animation
-  displayManager.performBrightnessAnimation();
-  displayManager.setIntensity(DISPLAY_INTENSITY);
+// Scheduler tasks (registered in setup())
 
-  // WiFi setup
-  wifiSetup.initialize();
+void startNetworkServices()
+{
+  if (WiFi.status() != WL_CONNECTED)
+  {
+    if (millis() - wifiStartMs < WIFI_ASYNC_CONNECT_TIMEOUT_MS)
+    {
+      return;
+    }
+    // The stored network did not come up: WiFiManager takes over (and opens
+    // the config portal if it cannot connect either).
+    Serial.println("Background Wi-Fi connect timed out");
+    wifiSetup.initialize();
+  }
+  BootTimeline::mark(BOOT_WIFI);
 
-  // Initialize OTA and Web OTA BEFORE any other network service.
-  // This guarantees firmware recovery is always reachable, even if a
-  // later service (MQTT/time) is slow or unreachable.
+  // OTA and Web OTA come up BEFORE any other network traffic (time sync,
+  // MQTT), so firmware recovery is always reachable even if a later service
+  // is slow or unreachable.
   otaManager.initialize();
   webOtaManager.initialize();
+  BootTimeline::mark(BOOT_SERVICES);
 
-  // Initialize MQTT last. Connection is established lazily in loop()
-  // (see mqttManager.loop()), so this call never blocks startup.
-  mqttManager.initialize();
-
-  // All network services are up: allow serviceBackground() to pump them during
-  // long display operations from now on.
+  // From now on the network tasks and serviceBackground() pump the services.
   servicesReady = true;
+  scheduler.cancel(networkInitTask);
+  scheduler.runIn(timeSyncTask, 0);
 }
 
-void loop()
+void pollNetwork()
 {
   // Feed the watchdog to prevent reset
   ESP.wdtFeed();
+  StallMonitor::feed();
 
-  // Check WiFi connection periodically
-  if (millis() - lastWiFiCheck > WIFI_CHECK_INTERVAL)
+  if (servicesReady)
   {
-    lastWiFiCheck = millis();
-    wifiSetup.checkConnection();
+    // Handle OTA updates
+    {
+      PROFILE_SECTION(PROFILE_OTA);
+      STALL_SECTION(STALL_OTA);
+      otaManager.loop();
+    }
+
+    // Handle Web OTA
+    {
+      PROFILE_SECTION(PROFILE_WEB);
+      STALL_SECTION(STALL_WEB);
+      HEAP_AUDIT_SCOPE(HEAP_WEB);
+      webOtaManager.loop();
+    }
   }
 
-  // Handle OTA updates
-  otaManager.loop();
+  // Handle MQTT (may show queued notifications, which block until done).
+  // Until Wi-Fi is up this only drives the queue and settings.
+  PROFILE_SECTION(PROFILE_MQTT);
+  STALL_SECTION(STALL_MQTT);
+  HEAP_AUDIT_SCOPE(HEAP_MQTT);
+  mqttManager.loop();
+}
 
-  // Handle Web OTA
-  webOtaManager.loop();
+void reconnectMqtt()
+{
+  if (!servicesReady)
+  {
+    return;
+  }
+  PROFILE_SECTION(PROFILE_MQTT_RECONNECT);
+  STALL_SECTION(STALL_MQTT_RECONNECT);
+  HEAP_AUDIT_SCOPE(HEAP_MQTT);
+  mqttManager.tryReconnect();
+}
 
-  // Handle MQTT
-  mqttManager.loop();
+void checkWiFi()
+{
+  if (!servicesReady)
+  {
+    return; // Still associating; startNetworkServices() owns Wi-Fi until then
+  }
+  PROFILE_SECTION(PROFILE_WIFI);
+  STALL_SECTION(STALL_WIFI_CHECK);
+  wifiSetup.checkConnection();
+}
 
-  // Update time if needed
-  if (timeManager.shouldUpdateTime())
+void syncTime()
+{
   {
+    PROFILE_SECTION(PROFILE_TIME);
+    HEAP_AUDIT_SCOPE(HEAP_TIME);
     timeManager.updateTime();
   }
+  if (timeManager.isTimeSynced())
+  {
+    BootTimeline::mark(BOOT_TIME_SYNCED);
+  }
+  scheduler.runIn(timeSyncTask, timeManager.nextSyncDelayMs());
+}
 
+void renderClock()
+{
   // Only show clock if not displaying notification
+  if (mqttManager.isShowingNotification())
+  {
+    return;
+  }
+  PROFILE_SECTION(PROFILE_RENDER);
+  HEAP_AUDIT_SCOPE(HEAP_DISPLAY);
+
+  // Update display when minute changes
+  timeManager.hasMinuteChanged();
+
+  // Display current time ("--:--" until the first sync)
+  if (timeManager.hasTime())
+  {
+    displayManager.showClock(hour(), minute(), second(), timeManager.isColonVisible());
+  }
+  else
+  {
+    displayManager.showClock(-1, 0, 0, true);
+  }
+  BootTimeline::mark(BOOT_FIRST_FRAME);
+
+  // Keep the RTC copy of the time fresh for a fast warm boot.
+  timeManager.saveToRtc();
+}
+
+void updateBrightness()
+{
   if (!mqttManager.isShowingNotification())
   {
-    // Update display when minute changes
-    timeManager.hasMinuteChanged();
+    PROFILE_SECTION(PROFILE_BRIGHTNESS);
+    mqttManager.updateBrightnessBasedOnTime();
+  }
+}
+
+void publishStatus()
+{
+  // Periodic refresh so HA sensors (Day/Night mode, etc.) stay current as the
+  // clock crosses a schedule boundary, even with no commands.
+  if (mqttManager.isConnected())
+  {
+    PROFILE_SECTION(PROFILE_PUBLISH);
+    mqttManager.sendStatus("online");
+  }
+}
+
+void applyPowerPolicy()
+{
+  // Deep idle only once the clock knows it is night; before the first time
+  // sync the schedule means nothing.
+  bool night = timeManager.hasTime() && !mqttManager.isDayTime();
+  const PowerPolicy &policy = night ? POWER_POLICY_NIGHT : POWER_POLICY_DAY;
+  PowerManager::setMode(mqttManager.isShowingNotification() ? POWER_MODEM_SLEEP : policy.mode);
+  scheduler.setInterval(networkTask, policy.networkPollMs);
+  scheduler.setInterval(renderTask, policy.renderIntervalMs);
+}
+
+void publishMetrics()
+{
+  // Heap telemetry, the notification latency window and (profiler builds)
+  // the loop timing window.
+  PROFILE_SECTION(PROFILE_PUBLISH);
+  mqttManager.sendMetrics();
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  delay(10);
+  BootTimeline::mark(BOOT_SETUP);
+
+  // Enable hardware watchdog (8 seconds timeout)
+  ESP.wdtEnable(WDTO_8S);
+  Serial.println("Watchdog enabled");
+
+  // Report how the previous boot ended, then start watching for stalls.
+  // Everything until the end of setup() counts as STALL_SETUP.
+  StallMonitor::begin();
+
+  // Initialize matrix display
+  displayManager.initializeMatrix();
+  BootTimeline::mark(BOOT_DISPLAY);
+
+  // Set hostname
+  wifiSetup.setHostname(DEVICE_HOSTNAME);
+
+  // After a warm reset (OTA, watchdog, reboot command) the clock should be
+  // back at once: skip the intro and show the time kept in RTC memory until
+  // the next sync confirms it.
+  bool fastBoot = FAST_BOOT && BootTimeline::isWarmBoot();
+  if (fastBoot)
+  {
+    timeManager.restoreFromRtc();
+  }
+  else
+  {
+    // Plays from the main loop while setup() carries on; the greeting stays
+    // up until it ends.
+    displayManager.performBrightnessAnimation();
+  }
+  if (!displayManager.isBrightnessAnimating())
+  {
+    displayManager.setIntensity(DISPLAY_INTENSITY);
+  }
+  BootTimeline::mark(BOOT_INTRO);
 
-    // Display current time
-    String currentTime = timeManager.getFormattedTime(false);
-    displayManager.fillScreen(LOW);
-    displayManager.centerPrint(currentTime);
+  // WiFi: associate in the background with the stored network, so the clock
+  // runs meanwhile. Without stored credentials WiFiManager has to run its
+  // portal anyway, which blocks as before.
+  if (!wifiSetup.beginAsync())
+  {
+    wifiSetup.initialize();
   }
+  wifiStartMs = millis();
+
+  // MQTT needs no network to initialize (settings, filesystem). Connection is
+  // established lazily by the reconnect task, so this never blocks startup.
+  mqttManager.initialize();
+  mqttManager.updateBrightnessBasedOnTime();
+  BootTimeline::mark(BOOT_SETTINGS);
+
+  // Everything loop() does is a scheduler task. When several are due at once
+  // the network ones go first, so a slow render never delays an OTA packet.
+  // OTA and web come up from the network-init task once Wi-Fi is associated;
+  // the time sync task is armed from there too.
+  networkInitTask = scheduler.addPeriodic("network-init", NETWORK_INIT_POLL_MS, TASK_PRIORITY_HIGH,
+                                          startNetworkServices);
+  networkTask = scheduler.addPeriodic("network", POWER_POLICY_DAY.networkPollMs, TASK_PRIORITY_HIGH, pollNetwork);
+  scheduler.addPeriodic("mqtt-reconnect", MQTT_RECONNECT_INTERVAL, TASK_PRIORITY_NORMAL, reconnectMqtt);
+  scheduler.addPeriodic("wifi-check", WIFI_CHECK_INTERVAL, TASK_PRIORITY_NORMAL, checkWiFi, WIFI_CHECK_INTERVAL);
+  timeSyncTask = scheduler.addOnce("time-sync", 0, TASK_PRIORITY_NORMAL, syncTime);
+  scheduler.cancel(timeSyncTask);
+  renderTask = scheduler.addPeriodic("render", POWER_POLICY_DAY.renderIntervalMs, TASK_PRIORITY_NORMAL, renderClock,
+                                     displayManager.brightnessAnimationRemainingMs());
+  scheduler.addPeriodic("power", POWER_POLICY_CHECK_INTERVAL_MS, TASK_PRIORITY_LOW, applyPowerPolicy);
+  scheduler.addPeriodic("brightness", BRIGHTNESS_UPDATE_INTERVAL_MS, TASK_PRIORITY_LOW, updateBrightness);
+  scheduler.addPeriodic("status", MQTT_STATUS_PUBLISH_INTERVAL, TASK_PRIORITY_LOW, publishStatus,
+                        MQTT_STATUS_PUBLISH_INTERVAL);
+  scheduler.addPeriodic("metrics", MQTT_METRICS_PUBLISH_INTERVAL, TASK_PRIORITY_LOW, publishMetrics,
+                        MQTT_METRICS_PUBLISH_INTERVAL);
+  scheduler.addPeriodic("heap", HEAP_SAMPLE_INTERVAL_MS, TASK_PRIORITY_LOW, HeapMonitor::sample);
+
+  StallMonitor::enter(STALL_LOOP);
+}
+
+void loop()
+{
+  ESP.wdtFeed();
+  StallMonitor::feed();
 
-  delay(LOOP_DELAY_MS);
+  // Run whatever is due, then idle until the nearest deadline (or the next
+  // brightness step or frame while a transition is running).
+  scheduler.run();
+  displayManager.tickBrightness();
+  displayManager.tickTransition();
+  displayManager.refreshPanelStep();
+  unsigned long idleMs = scheduler.msUntilNextDeadline();
+  if (displayManager.isBrightnessAnimating() && idleMs > BRIGHTNESS_TICK_MS)
+  {
+    idleMs = BRIGHTNESS_TICK_MS;
+  }
+  if (displayManager.isTransitionRunning() && idleMs > TRANSITION_FRAME_MS)
+  {
+    idleMs = TRANSITION_FRAME_MS;
+  }
+  PowerManager::idle(idleMs);
 }
@@ -0,0 +1,37 @@
+#pragma once
+// The part of Adafruit_GFX that FrameLayer and Max72xxPanel build on.
+#include "Arduino.h"
+
+class Adafruit_GFX
+{
+public:
+  Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h), rotation(0) {}
+  virtual ~Adafruit_GFX() {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+  virtual void fillScreen(uint16_t color)
+  {
+    for (int16_t y = 0; y < _height; y++)
+    {
+      for (int16_t x = 0; x < _width; x++)
+      {
+        drawPixel(x, y, color);
+      }
+    }
+  }
+
+  void setRotation(uint8_t r)
+  {
+    rotation = r & 3;
+    _width = (rotation & 1) ? HEIGHT : WIDTH;
+    _height = (rotation & 1) ? WIDTH : HEIGHT;
+  }
+  uint8_t getRotation() const { return rotation; }
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+
+protected:
+  const int16_t WIDTH, HEIGHT;
+  int16_t _width, _height;
+  uint8_t rotation;
+};
@@ -0,0 +1,53 @@
+#pragma once
+// Host stand-ins for the Arduino core, just enough for the pure display and
+// text code the native tests build (see [env:native] in platformio.ini).
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define memcpy_P memcpy
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+
+using std::max;
+using std::min;
+
+inline unsigned long micros()
+{
+  using namespace std::chrono;
+  static const steady_clock::time_point start = steady_clock::now();
+  return (unsigned long)duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+inline unsigned long millis() { return micros() / 1000; }
+inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+
+class String : public std::string
+{
+public:
+  String() {}
+  String(const char *text) : std::string(text) {}
+  String(const std::string &text) : std::string(text) {}
+
+  bool endsWith(const char *suffix) const
+  {
+    size_t n = strlen(suffix);
+    return size() >= n && compare(size() - n, n, suffix) == 0;
+  }
+  void remove(size_t index) { erase(index); }
+};
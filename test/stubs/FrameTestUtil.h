@@ -0,0 +1,40 @@
+#pragma once
+// Helpers shared by the native suites that draw on FrameLayers.
+#include "FrameLayer.h"
+
+// Deterministic pseudo-random numbers, so a failing case fails every run.
+inline uint32_t testRandomState = 1;
+
+inline uint32_t nextRandom()
+{
+  testRandomState = testRandomState * 1103515245UL + 12345UL;
+  return testRandomState >> 8;
+}
+
+inline bool pixel(const FrameLayer &layer, int16_t x, int16_t y)
+{
+  return (layer.row(y)[x >> 5] >> (31 - (x & 31))) & 1;
+}
+
+// Column x from row y down as a byte, bit 0 = top (the panel's column layout).
+inline uint8_t column(const FrameLayer &layer, int16_t x, int16_t y = 0)
+{
+  uint8_t bits = 0;
+  for (int16_t i = 0; i < 8 && y + i < layer.height(); i++)
+  {
+    bits |= pixel(layer, x, y + i) << i;
+  }
+  return bits;
+}
+
+// Every pixel set at random.
+inline void scribble(FrameLayer &layer)
+{
+  for (int16_t y = 0; y < layer.height(); y++)
+  {
+    for (int16_t x = 0; x < layer.width(); x++)
+    {
+      layer.drawPixel(x, y, nextRandom() & 1);
+    }
+  }
+}
@@ -0,0 +1,38 @@
+#pragma once
+// A filesystem holding no data: the native tests read animations from
+// PROGMEM. openDir() lists the names in LittleFS.files, for namesJson().
+#include <vector>
+#include "Arduino.h"
+
+class File
+{
+public:
+  explicit operator bool() const { return false; }
+  size_t read(uint8_t *, size_t) { return 0; }
+  bool seek(size_t) { return false; }
+  void close() {}
+};
+
+class Dir
+{
+public:
+  explicit Dir(const std::vector<String> &namesRef) : names(namesRef), index(-1) {}
+  bool next() { return ++index < (int)names.size(); }
+  String fileName() const { return names[index]; }
+
+private:
+  const std::vector<String> &names;
+  int index;
+};
+
+class LittleFSClass
+{
+public:
+  std::vector<String> files;
+
+  File open(const String &, const char *) { return File(); }
+  bool exists(const String &) { return false; }
+  Dir openDir(const char *) { return Dir(files); }
+};
+
+inline LittleFSClass LittleFS;
@@ -0,0 +1,19 @@
+#pragma once
+// Records what the panel driver sends, so tests can compare whole frames.
+#include <vector>
+#include "Arduino.h"
+
+class SPIClass
+{
+public:
+  std::vector<uint8_t> sent;
+
+  void begin() {}
+  uint8_t transfer(uint8_t data)
+  {
+    sent.push_back(data);
+    return 0;
+  }
+};
+
+inline SPIClass SPI;
@@ -0,0 +1,233 @@
+#include <unity.h>
+#include "Animation.h"
+#include "FrameTestUtil.h"
+
+static void assertColumns(const FrameLayer &layer, const uint8_t *expected, int16_t count)
+{
+  for (int16_t x = 0; x < count; x++)
+  {
+    char message[16];
+    snprintf(message, sizeof(message), "column %d", x);
+    TEST_ASSERT_EQUAL_HEX8_MESSAGE(expected[x], column(layer, x), message);
+  }
+}
+
+void test_keep_fill_and_literal_ops(void)
+{
+  static const uint8_t data[] = {
+      'A', 'N', 6, 1,
+      5, 0x82, 0x01, 0x02, 0x03, 0x42, 0xFF,  // 3 literals, fill 3
+      10, 0x01, 0x80, 0x55, 0x02,             // keep 2, 1 literal, keep 3
+      1, 0x45, 0x00,                          // fill all 6 with blank
+  };
+  ProgmemAnimationSource source(data, sizeof(data));
+  AnimationPlayer player(source);
+  FrameLayer layer(6, 8);
+  TEST_ASSERT_TRUE(player.begin());
+  TEST_ASSERT_EQUAL(6, player.width());
+  TEST_ASSERT_EQUAL(1, player.loops());
+
+  TEST_ASSERT_EQUAL(50, player.nextFrame(layer, 0));
+  const uint8_t first[] = {0x01, 0x02, 0x03, 0xFF, 0xFF, 0xFF};
+  assertColumns(layer, first, 6);
+
+  TEST_ASSERT_EQUAL(100, player.nextFrame(layer, 0));
+  const uint8_t second[] = {0x01, 0x02, 0x55, 0xFF, 0xFF, 0xFF};
+  assertColumns(layer, second, 6);
+
+  TEST_ASSERT_EQUAL(10, player.nextFrame(layer, 0));
+  const uint8_t blank[6] = {};
+  assertColumns(layer, blank, 6);
+
+  TEST_ASSERT_EQUAL(0, player.nextFrame(layer, 0));
+  TEST_ASSERT_FALSE(player.isCorrupt());
+}
+
+void test_each_loop_starts_from_blank(void)
+{
+  static const uint8_t data[] = {
+      'A', 'N', 3, 2,
+      1, 0x80, 0x0F, 0x01,  // Column 0 lit, 1-2 kept
+      1, 0x01, 0x80, 0xF0,  // Column 2 lit
+  };
+  ProgmemAnimationSource source(data, sizeof(data));
+  AnimationPlayer player(source);
+  FrameLayer layer(3, 8);
+  TEST_ASSERT_TRUE(player.begin());
+
+  const uint8_t firstFrame[] = {0x0F, 0x00, 0x00};
+  const uint8_t secondFrame[] = {0x0F, 0x00, 0xF0};
+  for (int loop = 0; loop < 2; loop++)
+  {
+    TEST_ASSERT_EQUAL(10, player.nextFrame(layer, 0));
+    assertColumns(layer, firstFrame, 3);
+    TEST_ASSERT_EQUAL(10, player.nextFrame(layer, 0));
+    assertColumns(layer, secondFrame, 3);
+  }
+  TEST_ASSERT_EQUAL(0, player.nextFrame(layer, 0));
+  TEST_ASSERT_FALSE(player.isCorrupt());
+}
+
+void test_columns_outside_the_layer_are_clipped(void)
+{
+  static const uint8_t data[] = {'A', 'N', 6, 1, 1, 0x85, 1, 2, 3, 4, 5, 6};
+  ProgmemAnimationSource source(data, sizeof(data));
+  AnimationPlayer player(source);
+  FrameLayer layer(4, 8);
+  TEST_ASSERT_TRUE(player.begin());
+  TEST_ASSERT_EQUAL(10, player.nextFrame(layer, -1));
+  const uint8_t expected[] = {2, 3, 4, 5};
+  assertColumns(layer, expected, 4);
+}
+
+void test_zero_duration_ends_the_animation(void)
+{
+  static const uint8_t data[] = {'A', 'N', 2, 1, 1, 0x41, 0x81, 0, 0xFF, 0xFF};
+  ProgmemAnimationSource source(data, sizeof(data));
+  AnimationPlayer player(source);
+  FrameLayer layer(2, 8);
+  TEST_ASSERT_TRUE(player.validate());
+  TEST_ASSERT_EQUAL(10, player.nextFrame(layer, 0));
+  TEST_ASSERT_EQUAL(0, player.nextFrame(layer, 0));
+  TEST_ASSERT_FALSE(player.isCorrupt());
+}
+
+static void assertCorrupt(const uint8_t *data, size_t length, const char *what)
+{
+  ProgmemAnimationSource source(data, length);
+  AnimationPlayer player(source);
+  FrameLayer layer(8, 8);
+  TEST_ASSERT_TRUE_MESSAGE(player.begin(), what);
+  while (player.nextFrame(layer, 0) > 0)
+  {
+  }
+  TEST_ASSERT_TRUE_MESSAGE(player.isCorrupt(), what);
+  TEST_ASSERT_FALSE_MESSAGE(player.validate(), what);
+}
+
+void test_corrupt_data_is_told_apart_from_the_end(void)
+{
+  static const uint8_t literalOverrun[] = {'A', 'N', 4, 1, 1, 0x83, 1, 2, 3, 4, 1, 0x84, 1, 2, 3, 4, 5};
+  static const uint8_t keepOverrun[] = {'A', 'N', 4, 1, 1, 0x02, 0x01};
+  static const uint8_t fillOverrun[] = {'A', 'N', 4, 1, 1, 0x44, 0xFF};
+  static const uint8_t truncatedLiteral[] = {'A', 'N', 4, 1, 1, 0x83, 1, 2};
+  static const uint8_t truncatedFill[] = {'A', 'N', 4, 1, 1, 0x43};
+  static const uint8_t truncatedFrame[] = {'A', 'N', 4, 1, 1, 0x01};
+  static const uint8_t durationOnly[] = {'A', 'N', 4, 1, 1, 0x03, 1};
+  assertCorrupt(literalOverrun, sizeof(literalOverrun), "literal overrun");
+  assertCorrupt(keepOverrun, sizeof(keepOverrun), "keep overrun");
+  assertCorrupt(fillOverrun, sizeof(fillOverrun), "fill overrun");
+  assertCorrupt(truncatedLiteral, sizeof(truncatedLiteral), "truncated literal");
+  assertCorrupt(truncatedFill, sizeof(truncatedFill), "truncated fill");
+  assertCorrupt(truncatedFrame, sizeof(truncatedFrame), "truncated frame");
+  assertCorrupt(durationOnly, sizeof(durationOnly), "duration without ops");
+}
+
+void test_validate_rejects_non_animations(void)
+{
+  static const uint8_t badMagic[] = {'A', 'M', 4, 1, 1, 0x03};
+  static const uint8_t zeroWidth[] = {'A', 'N', 0, 1, 1};
+  static const uint8_t noFrames[] = {'A', 'N', 4, 1};
+  static const uint8_t shortHeader[] = {'A', 'N', 4};
+  const uint8_t *files[] = {badMagic, zeroWidth, noFrames, shortHeader};
+  const size_t lengths[] = {sizeof(badMagic), sizeof(zeroWidth), sizeof(noFrames), sizeof(shortHeader)};
+  for (int i = 0; i < 4; i++)
+  {
+    ProgmemAnimationSource source(files[i], lengths[i]);
+    AnimationPlayer player(source);
+    TEST_ASSERT_FALSE(player.validate());
+  }
+}
+
+void test_validate_leaves_the_player_at_the_start(void)
+{
+  static const uint8_t data[] = {'A', 'N', 1, 3, 7, 0x80, 0x42, 9, 0x00};
+  ProgmemAnimationSource source(data, sizeof(data));
+  AnimationPlayer player(source);
+  FrameLayer layer(1, 8);
+  TEST_ASSERT_TRUE(player.validate());
+  TEST_ASSERT_EQUAL(3, player.loops());
+  int frames = 0;
+  while (player.nextFrame(layer, 0) > 0)
+  {
+    frames++;
+  }
+  TEST_ASSERT_EQUAL(6, frames);
+  TEST_ASSERT_FALSE(player.isCorrupt());
+}
+
+void test_builtins_decode_to_the_end(void)
+{
+  const char *names[] = {"heart", "wave", "pulse"};
+  for (const char *name : names)
+  {
+    size_t length = 0;
+    const uint8_t *data = AnimationPlayer::builtin(name, length);
+    TEST_ASSERT_NOT_NULL(data);
+    ProgmemAnimationSource source(data, length);
+    AnimationPlayer player(source);
+    TEST_ASSERT_TRUE_MESSAGE(player.validate(), name);
+
+    FrameLayer layer(player.width(), 8);
+    unsigned long totalMs = 0;
+    unsigned long ms;
+    while ((ms = player.nextFrame(layer, 0)) > 0)
+    {
+      totalMs += ms;
+    }
+    TEST_ASSERT_FALSE_MESSAGE(player.isCorrupt(), name);
+    TEST_ASSERT_TRUE_MESSAGE(totalMs > 0, name);
+  }
+  size_t length;
+  TEST_ASSERT_NULL(AnimationPlayer::builtin("nope", length));
+}
+
+void test_names(void)
+{
+  TEST_ASSERT_TRUE(AnimationPlayer::isValidName("spinner_2-b"));
+  TEST_ASSERT_FALSE(AnimationPlayer::isValidName(""));
+  TEST_ASSERT_FALSE(AnimationPlayer::isValidName("Spinner"));
+  TEST_ASSERT_FALSE(AnimationPlayer::isValidName("a.b"));
+  TEST_ASSERT_FALSE(AnimationPlayer::isValidName("abcdefghijklmnopqrstuvwxy")); // 25
+  TEST_ASSERT_EQUAL_STRING("/anim/spinner.anim", AnimationPlayer::pathFor("spinner").c_str());
+}
+
+void test_names_json_fits_the_limit(void)
+{
+  LittleFS.files = {"spinner.anim", "heart.anim", "upload.tmp", "Bad.anim", "rain.anim"};
+  TEST_ASSERT_EQUAL_STRING("[\"heart\",\"wave\",\"pulse\",\"spinner\",\"rain\"]",
+                           AnimationPlayer::namesJson().c_str());
+
+  // Room for the built-ins and "spinner" only.
+  String capped = AnimationPlayer::namesJson(strlen("[\"heart\",\"wave\",\"pulse\",\"spinner\"]") + 6);
+  TEST_ASSERT_EQUAL_STRING("[\"heart\",\"wave\",\"pulse\",\"spinner\"]", capped.c_str());
+
+  LittleFS.files.clear();
+  for (int i = 0; i < 100; i++)
+  {
+    char name[32];
+    snprintf(name, sizeof(name), "uploaded_animation_%03d.anim", i);
+    LittleFS.files.push_back(name);
+  }
+  String json = AnimationPlayer::namesJson(600);
+  TEST_ASSERT_LESS_OR_EQUAL(600, json.length());
+  TEST_ASSERT_GREATER_OR_EQUAL(570, json.length()); // Within one name of the limit
+  TEST_ASSERT_EQUAL(']', json[json.length() - 1]);
+  LittleFS.files.clear();
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_keep_fill_and_literal_ops);
+  RUN_TEST(test_each_loop_starts_from_blank);
+  RUN_TEST(test_columns_outside_the_layer_are_clipped);
+  RUN_TEST(test_zero_duration_ends_the_animation);
+  RUN_TEST(test_corrupt_data_is_told_apart_from_the_end);
+  RUN_TEST(test_validate_rejects_non_animations);
+  RUN_TEST(test_validate_leaves_the_player_at_the_start);
+  RUN_TEST(test_builtins_decode_to_the_end);
+  RUN_TEST(test_names);
+  RUN_TEST(test_names_json_fits_the_limit);
+  return UNITY_END();
+}
@@ -0,0 +1,156 @@
+#include <unity.h>
+#include <SPI.h>
+#include "Compositor.h"
+#include "FrameTestUtil.h"
+
+// A 16-module chain: four row words, so windows can straddle word edges.
+const int16_t PANEL_WIDTH = 128;
+const int16_t PANEL_HEIGHT = 8;
+
+struct Model
+{
+  FrameLayer *layer;
+  LayerBlend blend;
+  int16_t x0;
+  int16_t x1;
+  bool visible;
+};
+
+// The blend rules applied one pixel at a time, as documented in Compositor.h.
+static bool composedPixel(const Model *models, uint8_t count, int16_t x, int16_t y)
+{
+  bool lit = false;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    const Model &m = models[i];
+    if (!m.visible || x < m.x0 || x >= m.x1 || x >= m.layer->width() || y >= m.layer->height())
+    {
+      continue;
+    }
+    bool on = pixel(*m.layer, x, y);
+    switch (m.blend)
+    {
+    case BLEND_OR:
+      lit = lit || on;
+      break;
+    case BLEND_XOR:
+      lit = lit != on;
+      break;
+    case BLEND_MASK:
+      lit = lit && !on;
+      break;
+    case BLEND_REPLACE:
+      lit = on;
+      break;
+    }
+  }
+  return lit;
+}
+
+static void assertComposition(Compositor &compositor, const Model *models, uint8_t count)
+{
+  FrameLayer target(PANEL_WIDTH, PANEL_HEIGHT);
+  compositor.composeInto(target);
+  for (int16_t y = 0; y < PANEL_HEIGHT; y++)
+  {
+    for (int16_t x = 0; x < PANEL_WIDTH; x++)
+    {
+      char message[32];
+      snprintf(message, sizeof(message), "pixel %d,%d", x, y);
+      TEST_ASSERT_EQUAL_MESSAGE(composedPixel(models, count, x, y), pixel(target, x, y), message);
+    }
+  }
+}
+
+void test_blends_and_windows_match_per_pixel_model(void)
+{
+  Max72xxPanel matrix(15, PANEL_WIDTH / 8, 1);
+  FrameLayer base(PANEL_WIDTH, PANEL_HEIGHT), xorLayer(PANEL_WIDTH, PANEL_HEIGHT);
+  FrameLayer mask(PANEL_WIDTH, PANEL_HEIGHT), replace(PANEL_WIDTH, PANEL_HEIGHT);
+  Model models[] = {
+      {&base, BLEND_OR, 0, PANEL_WIDTH, true},
+      {&xorLayer, BLEND_XOR, 0, PANEL_WIDTH, true},
+      {&mask, BLEND_MASK, 0, PANEL_WIDTH, true},
+      {&replace, BLEND_REPLACE, 0, PANEL_WIDTH, true},
+  };
+
+  Compositor compositor(matrix);
+  for (Model &m : models)
+  {
+    TEST_ASSERT_NOT_EQUAL(-1, compositor.addLayer(*m.layer, m.blend));
+  }
+  TEST_ASSERT_EQUAL(-1, compositor.addLayer(base, BLEND_OR));
+
+  for (int round = 0; round < 200; round++)
+  {
+    for (uint8_t i = 0; i < 4; i++)
+    {
+      Model &m = models[i];
+      scribble(*m.layer);
+      m.blend = (LayerBlend)(nextRandom() % 4);
+      m.visible = nextRandom() % 4 != 0;
+      int16_t a = nextRandom() % (PANEL_WIDTH + 1);
+      int16_t b = nextRandom() % (PANEL_WIDTH + 1);
+      m.x0 = min(a, b);
+      m.x1 = max(a, b);
+      compositor.setBlend(i, m.blend);
+      compositor.setVisible(i, m.visible);
+      compositor.setWindow(i, m.x0, m.x1);
+    }
+    assertComposition(compositor, models, 4);
+  }
+}
+
+void test_windows_are_clamped_to_the_layer(void)
+{
+  Max72xxPanel matrix(15, PANEL_WIDTH / 8, 1);
+  FrameLayer narrow(40, PANEL_HEIGHT);
+  narrow.fillScreen(1);
+  Model model = {&narrow, BLEND_OR, 0, 40, true};
+
+  Compositor compositor(matrix);
+  compositor.addLayer(narrow, BLEND_OR);
+  compositor.setWindow(0, -20, 500);
+  assertComposition(compositor, &model, 1);
+}
+
+void test_present_sends_the_composition(void)
+{
+  Max72xxPanel matrix(15, PANEL_WIDTH / 8, 1);
+  Max72xxPanel reference(15, PANEL_WIDTH / 8, 1);
+  FrameLayer base(PANEL_WIDTH, PANEL_HEIGHT), overlay(PANEL_WIDTH, PANEL_HEIGHT);
+  scribble(base);
+  scribble(overlay);
+
+  Compositor compositor(matrix);
+  compositor.addLayer(base, BLEND_OR);
+  compositor.addLayer(overlay, BLEND_XOR);
+  compositor.setWindow(1, 13, 77);
+
+  FrameLayer composed(PANEL_WIDTH, PANEL_HEIGHT);
+  compositor.composeInto(composed);
+  for (int16_t y = 0; y < PANEL_HEIGHT; y++)
+  {
+    for (int16_t x = 0; x < PANEL_WIDTH; x++)
+    {
+      reference.drawPixel(x, y, pixel(composed, x, y));
+    }
+  }
+
+  SPI.sent.clear();
+  reference.write();
+  std::vector<uint8_t> expected = SPI.sent;
+  SPI.sent.clear();
+  compositor.present();
+  TEST_ASSERT_EQUAL(expected.size(), SPI.sent.size());
+  TEST_ASSERT_EQUAL_MEMORY(expected.data(), SPI.sent.data(), expected.size());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_blends_and_windows_match_per_pixel_model);
+  RUN_TEST(test_windows_are_clamped_to_the_layer);
+  RUN_TEST(test_present_sends_the_composition);
+  return UNITY_END();
+}
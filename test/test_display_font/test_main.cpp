@@ -0,0 +1,50 @@
+#include <unity.h>
+#include "DisplayFont.h"
+#include "TextEncoding.h"
+
+static bool sameGlyph(uint8_t a, uint8_t b)
+{
+  return fontGlyphWidth(a) == fontGlyphWidth(b) &&
+         memcmp(fontGlyphColumns(a), fontGlyphColumns(b), fontGlyphWidth(a)) == 0;
+}
+
+void test_extended_glyphs_are_distinct(void)
+{
+  // Every Polish letter must be readable on its own: no two extended glyphs
+  // (in particular a capital and its lowercase) may share a bitmap.
+  for (uint8_t a = GLYPH_EXT_FIRST; a < GLYPH_EXT_FIRST + GLYPH_EXT_COUNT; a++)
+  {
+    TEST_ASSERT_TRUE(fontHasGlyph(a));
+    for (uint8_t b = a + 1; b < GLYPH_EXT_FIRST + GLYPH_EXT_COUNT; b++)
+    {
+      char message[24];
+      snprintf(message, sizeof(message), "0x%02X vs 0x%02X", a, b);
+      TEST_ASSERT_FALSE_MESSAGE(sameGlyph(a, b), message);
+    }
+  }
+}
+
+void test_extended_glyphs_differ_from_base_letters(void)
+{
+  const char base[GLYPH_EXT_COUNT + 1] = "AaCcEeLlNnOSsZzZz";
+  for (uint8_t i = 0; i < GLYPH_EXT_COUNT; i++)
+  {
+    TEST_ASSERT_FALSE(sameGlyph(GLYPH_EXT_FIRST + i, base[i]));
+  }
+}
+
+void test_text_width_spaces_between_glyphs(void)
+{
+  const char text[] = {'i', GLYPH_L_STROKE, 'W'};
+  int expected = fontGlyphWidth('i') + fontGlyphWidth(GLYPH_L_STROKE) + fontGlyphWidth('W') + 2 * FONT_SPACING;
+  TEST_ASSERT_EQUAL(expected, fontTextWidth(text, sizeof(text)));
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_extended_glyphs_are_distinct);
+  RUN_TEST(test_extended_glyphs_differ_from_base_letters);
+  RUN_TEST(test_text_width_spaces_between_glyphs);
+  return UNITY_END();
+}
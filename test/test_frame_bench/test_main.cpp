@@ -0,0 +1,209 @@
+#include <unity.h>
+#include <vector>
+#include <SPI.h>
+#include "Compositor.h"
+#include "DisplayFont.h"
+
+// Frame cost of a scrolling ticker beside the compact clock on a 16-module
+// chain: the row-word layers and Compositor::present() against the
+// column-per-byte layers and per-column composition they replaced. Both
+// paths must send the same bytes; the timings are printed, not asserted.
+const int16_t PANEL_WIDTH = 128;
+const uint8_t MODULES = PANEL_WIDTH / 8;
+const uint8_t MODULE_ROTATION = 3; // LED_ROTATION in Settings.h
+const int16_t TICKER_LEFT = 18;
+const int FRAMES = 2000;
+
+static void setUpPanel(Max72xxPanel &matrix)
+{
+  for (uint8_t i = 0; i < MODULES; i++)
+  {
+    matrix.setRotation(i, MODULE_ROTATION);
+    matrix.setPosition(i, MODULES - i - 1, 0);
+  }
+}
+
+static std::vector<uint8_t> strip; // Column bytes of the ticker text
+
+static std::vector<uint8_t> tickerColumns()
+{
+  static const char TEXT[] = "Zegar MQTT 12:34 - test przewijania tekstu 0123456789 ";
+  std::vector<uint8_t> columns;
+  for (int repeat = 0; repeat < 20; repeat++)
+  {
+    for (const char *c = TEXT; *c; c++)
+    {
+      const uint8_t *glyph = fontGlyphColumns(*c);
+      for (uint8_t col = 0; col < fontGlyphWidth(*c); col++)
+      {
+        columns.push_back(pgm_read_byte(&glyph[col]));
+      }
+      columns.push_back(0);
+    }
+  }
+  return columns;
+}
+
+static uint8_t stripAt(size_t i)
+{
+  return i < strip.size() ? strip[i] : 0;
+}
+
+// The previous path: a byte per column per layer, every visible column of
+// the ticker redrawn each frame, layers blended column by column and
+// handed to the panel through drawColumn().
+struct ColumnPath
+{
+  Max72xxPanel matrix;
+  uint8_t clock[PANEL_WIDTH];
+  uint8_t ticker[PANEL_WIDTH];
+  uint8_t overlay[PANEL_WIDTH];
+
+  ColumnPath() : matrix(15, MODULES, 1), clock(), ticker(), overlay() { setUpPanel(matrix); }
+
+  void frame(size_t step)
+  {
+    memset(ticker, 0, sizeof(ticker));
+    for (int16_t x = TICKER_LEFT; x < PANEL_WIDTH; x++)
+    {
+      ticker[x] = stripAt(step + x - TICKER_LEFT);
+    }
+    for (int16_t x = 0; x < PANEL_WIDTH; x++)
+    {
+      uint8_t bits = 0;
+      if (x < TICKER_LEFT - 1)
+      {
+        bits |= clock[x];
+      }
+      if (x >= TICKER_LEFT)
+      {
+        bits |= ticker[x];
+      }
+      bits ^= overlay[x];
+      matrix.drawColumn(x, 0, bits);
+    }
+    matrix.write();
+  }
+};
+
+// The current path: the ticker slides a column with scrollLeft() and only
+// the entering column is drawn; Compositor::present() blends row words.
+struct RowWordPath
+{
+  Max72xxPanel matrix;
+  FrameLayer clock;
+  FrameLayer ticker;
+  FrameLayer overlay;
+  Compositor compositor;
+
+  RowWordPath() : matrix(15, MODULES, 1), clock(PANEL_WIDTH, 8), ticker(PANEL_WIDTH, 8), overlay(PANEL_WIDTH, 8), compositor(matrix)
+  {
+    setUpPanel(matrix);
+    compositor.setWindow(compositor.addLayer(clock, BLEND_OR), 0, TICKER_LEFT - 1);
+    compositor.setWindow(compositor.addLayer(ticker, BLEND_OR), TICKER_LEFT, PANEL_WIDTH);
+    compositor.addLayer(overlay, BLEND_XOR);
+  }
+
+  void frame(size_t step)
+  {
+    if (step == 0)
+    {
+      for (int16_t x = TICKER_LEFT; x < PANEL_WIDTH; x++)
+      {
+        ticker.drawColumn(x, 0, stripAt(x - TICKER_LEFT));
+      }
+    }
+    else
+    {
+      ticker.scrollLeft(TICKER_LEFT, PANEL_WIDTH, 1);
+      ticker.drawColumn(PANEL_WIDTH - 1, 0, stripAt(step + PANEL_WIDTH - 1 - TICKER_LEFT));
+    }
+    compositor.present();
+  }
+};
+
+static void drawClock(ColumnPath &columns, RowWordPath &rowWords)
+{
+  // Something clock-like in the compact clock's window, and a marker pixel
+  // on the overlay.
+  for (int16_t x = 0; x < TICKER_LEFT - 1; x++)
+  {
+    uint8_t bits = (x % 4 == 3) ? 0 : 0x3E ^ (x * 37);
+    columns.clock[x] = bits;
+    rowWords.clock.drawColumn(x, 0, bits);
+  }
+  columns.overlay[PANEL_WIDTH - 1] = 0x80;
+  rowWords.overlay.drawPixel(PANEL_WIDTH - 1, 7, HIGH);
+}
+
+template <typename Path>
+static std::vector<uint8_t> frameBytes(Path &path, size_t step)
+{
+  SPI.sent.clear();
+  path.frame(step);
+  return SPI.sent;
+}
+
+void test_both_paths_send_the_same_frames(void)
+{
+  ColumnPath columns;
+  RowWordPath rowWords;
+  drawClock(columns, rowWords);
+  for (size_t step = 0; step < strip.size(); step++)
+  {
+    std::vector<uint8_t> expected = frameBytes(columns, step);
+    std::vector<uint8_t> actual = frameBytes(rowWords, step);
+    TEST_ASSERT_EQUAL(expected.size(), actual.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected.data(), actual.data(), expected.size());
+  }
+}
+
+template <typename Path>
+static unsigned long microsPerFrame(Path &path)
+{
+  unsigned long start = micros();
+  for (int step = 0; step < FRAMES; step++)
+  {
+    if (step % 256 == 0)
+    {
+      SPI.sent.clear();
+    }
+    path.frame(step);
+  }
+  return (micros() - start) * 1000 / FRAMES;
+}
+
+void test_report_frame_cost(void)
+{
+  ColumnPath columns;
+  RowWordPath rowWords;
+  drawClock(columns, rowWords);
+
+  unsigned long writeStart = micros();
+  for (int i = 0; i < FRAMES; i++)
+  {
+    if (i % 256 == 0)
+    {
+      SPI.sent.clear();
+    }
+    columns.matrix.write();
+  }
+  unsigned long writeOnly = (micros() - writeStart) * 1000 / FRAMES;
+  unsigned long columnCost = microsPerFrame(columns);
+  unsigned long rowWordCost = microsPerFrame(rowWords);
+
+  char message[128];
+  snprintf(message, sizeof(message), "ns/frame: column path %lu, row-word path %lu, of which SPI write %lu",
+           columnCost, rowWordCost, writeOnly);
+  TEST_MESSAGE(message);
+  SPI.sent.clear();
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  strip = tickerColumns();
+  RUN_TEST(test_both_paths_send_the_same_frames);
+  RUN_TEST(test_report_frame_cost);
+  return UNITY_END();
+}
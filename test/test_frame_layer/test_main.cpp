@@ -0,0 +1,171 @@
+#include <unity.h>
+#include <vector>
+#include <SPI.h>
+#include <Adafruit_GFX.h>
+#include <Max72xxPanel.h>
+#include "FrameLayer.h"
+#include "FrameTestUtil.h"
+
+void test_column_mask_covers_exactly_the_range(void)
+{
+  for (int16_t x0 = -3; x0 < 100; x0++)
+  {
+    for (int16_t x1 = x0; x1 < 100; x1++)
+    {
+      for (uint8_t word = 0; word < 3; word++)
+      {
+        uint32_t expected = 0;
+        for (int16_t x = max(x0, (int16_t)(word * 32)); x < min(x1, (int16_t)(word * 32 + 32)); x++)
+        {
+          expected |= 0x80000000UL >> (x & 31);
+        }
+        TEST_ASSERT_EQUAL_HEX32(expected, columnMask(x0, x1, word));
+      }
+    }
+  }
+}
+
+// A layer wider than six words, so shifts cross several word edges.
+const int16_t WIDE = 200;
+
+void test_scroll_left_matches_moving_pixels(void)
+{
+  FrameLayer layer(WIDE, 8);
+  std::vector<uint8_t> before(WIDE * 8);
+  for (int round = 0; round < 2000; round++)
+  {
+    scribble(layer);
+    for (int16_t y = 0; y < 8; y++)
+    {
+      for (int16_t x = 0; x < WIDE; x++)
+      {
+        before[y * WIDE + x] = pixel(layer, x, y);
+      }
+    }
+    int16_t x0 = nextRandom() % WIDE;
+    int16_t x1 = x0 + 1 + nextRandom() % (WIDE - x0);
+    int16_t n = nextRandom() % (x1 - x0 + 3);
+    if (round % 4 == 0)
+    {
+      n = nextRandom() % 3 * 32 + nextRandom() % 2; // Whole-word shifts
+    }
+    layer.scrollLeft(x0, x1, n);
+
+    for (int16_t y = 0; y < 8; y++)
+    {
+      for (int16_t x = 0; x < WIDE; x++)
+      {
+        bool expected = before[y * WIDE + x];
+        if (x >= x0 && x < x1)
+        {
+          expected = x + n < x1 && before[y * WIDE + x + n];
+        }
+        char message[64];
+        snprintf(message, sizeof(message), "[%d,%d) by %d, pixel %d,%d", x0, x1, n, x, y);
+        TEST_ASSERT_EQUAL_MESSAGE(expected, pixel(layer, x, y), message);
+      }
+    }
+  }
+}
+
+void test_clear_columns_and_draw_column(void)
+{
+  FrameLayer layer(WIDE, 16);
+  layer.fillScreen(1);
+  layer.clearColumns(30, 70);
+  layer.drawColumn(40, -3, 0xFF);  // Clipped at the top: rows 0-4
+  layer.drawColumn(41, 12, 0x05);  // Clipped at the bottom: rows 12 and 14
+  layer.drawColumn(WIDE, 0, 0xFF); // Off the layer
+  for (int16_t y = 0; y < 16; y++)
+  {
+    for (int16_t x = 0; x < WIDE; x++)
+    {
+      bool expected = x < 30 || x >= 70;
+      if (x == 40)
+      {
+        expected = y < 5;
+      }
+      if (x == 41)
+      {
+        expected = y == 12 || y == 14;
+      }
+      TEST_ASSERT_EQUAL(expected, pixel(layer, x, y));
+    }
+  }
+}
+
+// drawRows() takes a shortcut per module rotation (a copy, reversed rows or
+// an 8x8 transpose); the panel must end up exactly as if every pixel had
+// been drawn on its own.
+static void assertDrawRowsMatchesDrawPixel(uint8_t moduleRotation, uint8_t canvasRotation)
+{
+  const uint8_t across = 4, down = 2;
+  Max72xxPanel fast(15, across, down), slow(15, across, down);
+  for (uint8_t i = 0; i < across * down; i++)
+  {
+    // Reversed positions, as DisplayManager sets them up.
+    fast.setPosition(i, across - 1 - i % across, i / across);
+    slow.setPosition(i, across - 1 - i % across, i / across);
+    fast.setRotation(i, moduleRotation);
+    slow.setRotation(i, moduleRotation);
+  }
+  fast.setRotation(canvasRotation);
+  slow.setRotation(canvasRotation);
+
+  for (int block = 0; block < 64; block++)
+  {
+    int16_t x = (nextRandom() % (fast.width() / 8)) * 8;
+    int16_t y = (nextRandom() % (fast.height() / 8)) * 8;
+    if (block % 8 == 7)
+    {
+      // Straddling two modules or the panel edge.
+      x += nextRandom() % 8 - 4;
+      y += nextRandom() % 8 - 4;
+    }
+    byte rows[8];
+    for (uint8_t row = 0; row < 8; row++)
+    {
+      rows[row] = nextRandom();
+    }
+
+    fast.drawRows(x, y, rows);
+    for (uint8_t row = 0; row < 8; row++)
+    {
+      for (uint8_t col = 0; col < 8; col++)
+      {
+        slow.drawPixel(x + col, y + row, (rows[row] >> (7 - col)) & 1);
+      }
+    }
+  }
+
+  SPI.sent.clear();
+  slow.write();
+  std::vector<uint8_t> expected = SPI.sent;
+  SPI.sent.clear();
+  fast.write();
+  char message[40];
+  snprintf(message, sizeof(message), "module %d, canvas %d", moduleRotation, canvasRotation);
+  TEST_ASSERT_EQUAL_MESSAGE(expected.size(), SPI.sent.size(), message);
+  TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected.data(), SPI.sent.data(), expected.size(), message);
+}
+
+void test_draw_rows_matches_draw_pixel(void)
+{
+  for (uint8_t moduleRotation = 0; moduleRotation < 4; moduleRotation++)
+  {
+    for (uint8_t canvasRotation = 0; canvasRotation < 4; canvasRotation++)
+    {
+      assertDrawRowsMatchesDrawPixel(moduleRotation, canvasRotation);
+    }
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_column_mask_covers_exactly_the_range);
+  RUN_TEST(test_scroll_left_matches_moving_pixels);
+  RUN_TEST(test_clear_columns_and_draw_column);
+  RUN_TEST(test_draw_rows_matches_draw_pixel);
+  return UNITY_END();
+}
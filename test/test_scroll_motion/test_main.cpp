@@ -0,0 +1,89 @@
+#include <unity.h>
+#include "ScrollMotion.h"
+
+void test_constant_speed_positions(void)
+{
+  ScrollMotion motion(30 * SCROLL_VELOCITY_ONE, SCROLL_CONSTANT, 0);
+  TEST_ASSERT_EQUAL(0, motion.position(0));
+  TEST_ASSERT_EQUAL(0, motion.position(33)); // 0.99 px
+  TEST_ASSERT_EQUAL(1, motion.position(34));
+  TEST_ASSERT_EQUAL(30, motion.position(1000));
+  TEST_ASSERT_EQUAL(108000, motion.position(3600000UL)); // An hour, no overflow
+}
+
+void test_fractional_speed(void)
+{
+  ScrollMotion motion(25 * SCROLL_VELOCITY_ONE / 2, SCROLL_CONSTANT, 0); // 12.5 px/s
+  TEST_ASSERT_EQUAL(12, motion.position(1000));
+  TEST_ASSERT_EQUAL(25, motion.position(2000));
+  TEST_ASSERT_EQUAL(80, motion.pixelPeriodMs());
+}
+
+void test_velocity_from_delay(void)
+{
+  TEST_ASSERT_EQUAL(25 * SCROLL_VELOCITY_ONE, scrollVelocityFromDelay(40));
+  TEST_ASSERT_EQUAL(1000 * SCROLL_VELOCITY_ONE, scrollVelocityFromDelay(0));
+  TEST_ASSERT_EQUAL(1000 * SCROLL_VELOCITY_ONE, scrollVelocityFromDelay(-5));
+
+  ScrollMotion motion(scrollVelocityFromDelay(40), SCROLL_CONSTANT, 0);
+  TEST_ASSERT_EQUAL(40, motion.pixelPeriodMs());
+  TEST_ASSERT_EQUAL(25, motion.position(1000));
+}
+
+void test_pixel_period_is_at_least_one_ms(void)
+{
+  ScrollMotion motion(5000 * SCROLL_VELOCITY_ONE, SCROLL_CONSTANT, 0);
+  TEST_ASSERT_EQUAL(1, motion.pixelPeriodMs());
+  ScrollMotion stopped(0, SCROLL_CONSTANT, 0); // Clamped to 1/256 px/s
+  TEST_ASSERT_EQUAL(256000, stopped.pixelPeriodMs());
+}
+
+// Eased scrolls of long and short texts: they never move backwards, never
+// jump by more than full speed allows, start slower than constant speed and
+// land exactly on the distance rampMs after a constant scroll would.
+static void assertEased(uint32_t pxPerSecond, uint32_t length)
+{
+  uint32_t velocity = pxPerSecond * SCROLL_VELOCITY_ONE;
+  ScrollMotion eased(velocity, SCROLL_EASED, length);
+  ScrollMotion constant(velocity, SCROLL_CONSTANT, length);
+  unsigned long cruiseMs = length * 1000UL / pxPerSecond;
+  unsigned long totalMs = cruiseMs + min(SCROLL_RAMP_MS, cruiseMs);
+  uint32_t maxStep = pxPerSecond / 1000 + 1;
+
+  char message[48];
+  snprintf(message, sizeof(message), "%u px/s over %u px", (unsigned)pxPerSecond, (unsigned)length);
+
+  uint32_t previous = 0;
+  for (unsigned long ms = 0; ms <= totalMs + 100; ms++)
+  {
+    uint32_t position = eased.position(ms);
+    TEST_ASSERT_TRUE_MESSAGE(position >= previous, message);
+    TEST_ASSERT_TRUE_MESSAGE(position - previous <= maxStep, message);
+    TEST_ASSERT_TRUE_MESSAGE(position <= length, message);
+    TEST_ASSERT_TRUE_MESSAGE(position <= constant.position(ms), message);
+    previous = position;
+  }
+  TEST_ASSERT_EQUAL_MESSAGE(length, eased.position(totalMs), message);
+  TEST_ASSERT_TRUE_MESSAGE(eased.position(totalMs - 2) < length, message);
+  TEST_ASSERT_EQUAL_MESSAGE(length, eased.position(totalMs * 10), message);
+}
+
+void test_eased_scrolls(void)
+{
+  assertEased(30, 300);  // Long text: full ramps and a cruise
+  assertEased(30, 12);   // Cruise shorter than a ramp
+  assertEased(30, 3);
+  assertEased(250, 1000);
+  assertEased(1, 5);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_constant_speed_positions);
+  RUN_TEST(test_fractional_speed);
+  RUN_TEST(test_velocity_from_delay);
+  RUN_TEST(test_pixel_period_is_at_least_one_ms);
+  RUN_TEST(test_eased_scrolls);
+  return UNITY_END();
+}
@@ -0,0 +1,196 @@
+#include <unity.h>
+#include "TextEncoding.h"
+
+// Expected display code for every code point U+00A0-U+017F, worked out from
+// the CP437 code page and the Unicode decompositions rather than copied from
+// the firmware's tables: the CP437 glyph where there is one, the extended
+// glyph for Polish letters, otherwise the unaccented base letter. Symbols and
+// letters with no base letter use the stand-ins listed in TextEncoding.cpp.
+static const uint8_t EXPECTED[0x180 - 0xA0] = {
+    ' ', 0xAD, 0x9B, 0x9C, '?', 0x9D, '|', 0x15, // 00A0  ¡¢£¤¥¦§
+    '"', 'c', 0xA6, 0xAE, 0xAA, '-', 'r', '-', // 00A8 ¨©ª«¬ ®¯
+    0xF8, 0xF1, 0xFD, '3', '\'', 0xE6, 0x14, 0xFA, // 00B0 °±²³´µ¶·
+    ',', '1', 0xA7, 0xAF, 0xAC, 0xAB, '?', 0xA8, // 00B8 ¸¹º»¼½¾¿
+    'A', 'A', 'A', 'A', 0x8E, 0x8F, 0x92, 0x80, // 00C0 ÀÁÂÃÄÅÆÇ
+    'E', 0x90, 'E', 'E', 'I', 'I', 'I', 'I', // 00C8 ÈÉÊËÌÍÎÏ
+    'D', 0xA5, 'O', GLYPH_O_ACUTE_UPPER, 'O', 'O', 0x99, 'x', // 00D0 ÐÑÒÓÔÕÖ×
+    'O', 'U', 'U', 'U', 0x9A, 'Y', 'P', 0xE1, // 00D8 ØÙÚÛÜÝÞß
+    0x85, 0xA0, 0x83, 'a', 0x84, 0x86, 0x91, 0x87, // 00E0 àáâãäåæç
+    0x8A, 0x82, 0x88, 0x89, 0x8D, 0xA1, 0x8C, 0x8B, // 00E8 èéêëìíîï
+    'd', 0xA4, 0x95, 0xA2, 0x93, 'o', 0x94, 0xF6, // 00F0 ðñòóôõö÷
+    'o', 0x97, 0xA3, 0x96, 0x81, 'y', 'p', 0x98, // 00F8 øùúûüýþÿ
+    'A', 'a', 'A', 'a', GLYPH_A_OGONEK_UPPER, GLYPH_A_OGONEK, GLYPH_C_ACUTE_UPPER, GLYPH_C_ACUTE, // 0100 ĀāĂăĄąĆć
+    'C', 'c', 'C', 'c', 'C', 'c', 'D', 'd', // 0108 ĈĉĊċČčĎď
+    'D', 'd', 'E', 'e', 'E', 'e', 'E', 'e', // 0110 ĐđĒēĔĕĖė
+    GLYPH_E_OGONEK_UPPER, GLYPH_E_OGONEK, 'E', 'e', 'G', 'g', 'G', 'g', // 0118 ĘęĚěĜĝĞğ
+    'G', 'g', 'G', 'g', 'H', 'h', 'H', 'h', // 0120 ĠġĢģĤĥĦħ
+    'I', 'i', 'I', 'i', 'I', 'i', 'I', 'i', // 0128 ĨĩĪīĬĭĮį
+    'I', 'i', 'J', 'j', 'J', 'j', 'K', 'k', // 0130 İıĲĳĴĵĶķ
+    'k', 'L', 'l', 'L', 'l', 'L', 'l', 'L', // 0138 ĸĹĺĻļĽľĿ
+    'l', GLYPH_L_STROKE_UPPER, GLYPH_L_STROKE, GLYPH_N_ACUTE_UPPER, GLYPH_N_ACUTE, 'N', 'n', 'N', // 0140 ŀŁłŃńŅņŇ
+    'n', 'n', 'N', 'n', 'O', 'o', 'O', 'o', // 0148 ňŉŊŋŌōŎŏ
+    'O', 'o', 'O', 'o', 'R', 'r', 'R', 'r', // 0150 ŐőŒœŔŕŖŗ
+    'R', 'r', GLYPH_S_ACUTE_UPPER, GLYPH_S_ACUTE, 'S', 's', 'S', 's', // 0158 ŘřŚśŜŝŞş
+    'S', 's', 'T', 't', 'T', 't', 'T', 't', // 0160 ŠšŢţŤťŦŧ
+    'U', 'u', 'U', 'u', 'U', 'u', 'U', 'u', // 0168 ŨũŪūŬŭŮů
+    'U', 'u', 'U', 'u', 'W', 'w', 'Y', 'y', // 0170 ŰűŲųŴŵŶŷ
+    'Y', GLYPH_Z_ACUTE_UPPER, GLYPH_Z_ACUTE, GLYPH_Z_DOT_UPPER, GLYPH_Z_DOT, 'Z', 'z', 's', // 0178 ŸŹźŻżŽžſ
+};
+
+// Convert in one call with ample room; returns the output as a string.
+static std::string convert(const std::string &in, size_t *consumed = nullptr)
+{
+  char out[64];
+  size_t used = 0;
+  size_t written = utf8ToCp437(in.data(), in.size(), out, sizeof(out), &used);
+  if (consumed)
+  {
+    *consumed = used;
+  }
+  return std::string(out, written);
+}
+
+static std::string utf8(uint32_t codePoint)
+{
+  std::string out;
+  if (codePoint < 0x80)
+  {
+    out += (char)codePoint;
+  }
+  else if (codePoint < 0x800)
+  {
+    out += (char)(0xC0 | (codePoint >> 6));
+    out += (char)(0x80 | (codePoint & 0x3F));
+  }
+  else if (codePoint < 0x10000)
+  {
+    out += (char)(0xE0 | (codePoint >> 12));
+    out += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+    out += (char)(0x80 | (codePoint & 0x3F));
+  }
+  else
+  {
+    out += (char)(0xF0 | (codePoint >> 18));
+    out += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+    out += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+    out += (char)(0x80 | (codePoint & 0x3F));
+  }
+  return out;
+}
+
+void test_latin1_and_extended_a(void)
+{
+  for (uint32_t codePoint = 0xA0; codePoint < 0x180; codePoint++)
+  {
+    char message[32];
+    snprintf(message, sizeof(message), "U+%04X", (unsigned)codePoint);
+    size_t consumed = 0;
+    std::string out = convert(utf8(codePoint), &consumed);
+    TEST_ASSERT_EQUAL_MESSAGE(2, consumed, message);
+    TEST_ASSERT_EQUAL_MESSAGE(1, out.size(), message);
+    TEST_ASSERT_EQUAL_HEX8_MESSAGE(EXPECTED[codePoint - 0xA0], (uint8_t)out[0], message);
+  }
+}
+
+void test_ascii_and_controls(void)
+{
+  TEST_ASSERT_EQUAL_STRING("Hello, World! ~", convert("Hello, World! ~").c_str());
+  TEST_ASSERT_EQUAL_STRING("a b c", convert("a\nb\tc").c_str()); // Controls become spaces
+  TEST_ASSERT_EQUAL_STRING("?", convert("\x7F").c_str());       // DEL
+  TEST_ASSERT_EQUAL_STRING("??", convert(utf8(0x80) + utf8(0x9F)).c_str()); // C1 controls
+}
+
+void test_symbols_outside_the_latin_ranges(void)
+{
+  TEST_ASSERT_EQUAL_HEX8(0xE3, (uint8_t)convert(utf8(0x03C0))[0]); // π
+  TEST_ASSERT_EQUAL_STRING("\"", convert(utf8(0x201E)).c_str());   // „
+  TEST_ASSERT_EQUAL_STRING("?", convert(utf8(0x20AC)).c_str());    // € has no glyph
+  TEST_ASSERT_EQUAL_STRING("?", convert(utf8(0x1F600)).c_str());   // Beyond the BMP
+}
+
+void test_malformed_input_reads_as_latin1(void)
+{
+  // A byte that does not start a well-formed sequence is taken as Latin-1
+  // on its own, and decoding resumes at the next byte.
+  TEST_ASSERT_EQUAL_STRING("?", convert("\x80").c_str());          // Lone continuation (C1)
+  TEST_ASSERT_EQUAL_STRING("\x82x", convert("\xE9x").c_str());     // Un-encoded é
+  TEST_ASSERT_EQUAL_STRING("\x8F", convert("\xC5").c_str());       // Truncated at the end: Å
+  TEST_ASSERT_EQUAL_STRING("\x83?", convert("\xE2\x82").c_str());  // Truncated 3-byte: â, then C1
+  TEST_ASSERT_EQUAL_STRING("\x98?", convert("\xFF\x80").c_str());  // Invalid lead: ÿ
+  TEST_ASSERT_EQUAL_STRING("\x85" "b", convert("\xE0" "b").c_str()); // Lead without continuation
+}
+
+void test_overlong_forms_are_rejected(void)
+{
+  // Each byte of a rejected sequence falls back to Latin-1.
+  TEST_ASSERT_EQUAL_STRING("A?", convert("\xC0\x81").c_str());           // 'A' in 2 bytes: À, C1
+  TEST_ASSERT_EQUAL_STRING("\x85?-", convert("\xE0\x80\xAF").c_str());   // '/' in 3 bytes: à, C1, ¯
+  TEST_ASSERT_EQUAL_STRING("d?" "?-", convert("\xF0\x80\x80\xAF").c_str()); // '/' in 4 bytes: ð, ...
+}
+
+void test_surrogates_and_out_of_range_are_rejected(void)
+{
+  TEST_ASSERT_EQUAL_STRING("\xA1 ?", convert("\xED\xA0\x80").c_str());         // U+D800: í, nbsp, C1
+  TEST_ASSERT_EQUAL_STRING("\xA1\xA8\xA8", convert("\xED\xBF\xBF").c_str());   // U+DFFF: í, ¿, ¿
+  TEST_ASSERT_EQUAL_STRING("\x93???", convert("\xF4\x90\x80\x80").c_str());    // Above U+10FFFF
+  size_t consumed = 0;
+  TEST_ASSERT_EQUAL_STRING("?", convert("\xF4\x8F\xBF\xBF", &consumed).c_str()); // U+10FFFF: one character
+  TEST_ASSERT_EQUAL(4, consumed);
+}
+
+void test_short_output_reports_consumed(void)
+{
+  const std::string in = "a" + utf8(0x0105) + "b"; // "aąb", 4 bytes
+  char out[4];
+  size_t consumed = 99;
+
+  TEST_ASSERT_EQUAL(0, utf8ToCp437(in.data(), in.size(), out, 0, &consumed));
+  TEST_ASSERT_EQUAL(0, consumed);
+
+  TEST_ASSERT_EQUAL(1, utf8ToCp437(in.data(), in.size(), out, 1, &consumed));
+  TEST_ASSERT_EQUAL(1, consumed); // Stops before 'ą'
+
+  TEST_ASSERT_EQUAL(2, utf8ToCp437(in.data(), in.size(), out, 2, &consumed));
+  TEST_ASSERT_EQUAL(3, consumed); // 'ą' was two input bytes
+  TEST_ASSERT_EQUAL_HEX8(GLYPH_A_OGONEK, (uint8_t)out[1]);
+
+  TEST_ASSERT_EQUAL(3, utf8ToCp437(in.data(), in.size(), out, 3, &consumed));
+  TEST_ASSERT_EQUAL(4, consumed);
+}
+
+void test_resuming_from_consumed_matches_one_pass(void)
+{
+  // Feeding the input back from *consumed with a tiny output buffer must
+  // give the same text as a single call: no sequence is split or dropped.
+  const std::string in = "Zażółć gęślą jaźń \xE9\xC0\x81 " + utf8(0x201E) + utf8(0x1F600) + "!";
+  const std::string expected = convert(in);
+  for (size_t outSize = 1; outSize <= 4; outSize++)
+  {
+    std::string result;
+    size_t offset = 0;
+    while (offset < in.size())
+    {
+      char out[4];
+      size_t consumed = 0;
+      size_t written = utf8ToCp437(in.data() + offset, in.size() - offset, out, outSize, &consumed);
+      TEST_ASSERT_TRUE(consumed > 0);
+      result.append(out, written);
+      offset += consumed;
+    }
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), result.c_str());
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_latin1_and_extended_a);
+  RUN_TEST(test_ascii_and_controls);
+  RUN_TEST(test_symbols_outside_the_latin_ranges);
+  RUN_TEST(test_malformed_input_reads_as_latin1);
+  RUN_TEST(test_overlong_forms_are_rejected);
+  RUN_TEST(test_surrogates_and_out_of_range_are_rejected);
+  RUN_TEST(test_short_output_reports_consumed);
+  RUN_TEST(test_resuming_from_consumed_matches_one_pass);
+  return UNITY_END();
+}
@@ -0,0 +1,161 @@
+#include <unity.h>
+#include "Transition.h"
+#include "FrameTestUtil.h"
+
+static uint32_t litPixels(const FrameLayer &layer)
+{
+  uint32_t count = 0;
+  for (int16_t y = 0; y < layer.height(); y++)
+  {
+    for (int16_t x = 0; x < layer.width(); x++)
+    {
+      count += pixel(layer, x, y);
+    }
+  }
+  return count;
+}
+
+static void fill(FrameLayer &layer, int16_t x0, int16_t y0, int16_t w, int16_t h)
+{
+  for (int16_t y = y0; y < y0 + h; y++)
+  {
+    for (int16_t x = x0; x < x0 + w; x++)
+    {
+      layer.drawPixel(x, y, 1);
+    }
+  }
+}
+
+// Dissolving from blank to lit: the lit count is the number of pixels the
+// LFSR has reached. Every pixel must be reached by the last running frame.
+static void assertDissolveCovers(int16_t width, int16_t height)
+{
+  FrameLayer from(width, height), to(width, height), out(width, height);
+  to.fillScreen(1);
+  Transition transition(from, to, out);
+  transition.begin(TRANSITION_DISSOLVE);
+
+  char message[48];
+  snprintf(message, sizeof(message), "%dx%d", width, height);
+  uint32_t pixels = (uint32_t)width * height;
+  uint32_t previous = litPixels(out);
+  TEST_ASSERT_EQUAL_MESSAGE(0, previous, message);
+  for (uint8_t frame = 1; frame < TRANSITION_FRAMES; frame++)
+  {
+    TEST_ASSERT_TRUE_MESSAGE(transition.step(), message);
+    uint32_t lit = litPixels(out);
+    TEST_ASSERT_TRUE_MESSAGE(lit >= previous, message);
+    previous = lit;
+  }
+  TEST_ASSERT_EQUAL_MESSAGE(pixels, previous, message);
+  TEST_ASSERT_FALSE(transition.step());
+  TEST_ASSERT_EQUAL_MESSAGE(pixels, litPixels(out), message);
+}
+
+void test_dissolve_reaches_every_pixel_for_each_lfsr_size(void)
+{
+  // 2^n - 1 pixels uses the full period of the n-bit LFSR.
+  for (uint8_t bits = 2; bits < 16; bits++)
+  {
+    assertDissolveCovers(1, (1 << bits) - 1);
+  }
+  assertDissolveCovers(255, 257); // 2^16 - 1
+}
+
+void test_dissolve_on_panel_sizes(void)
+{
+  assertDissolveCovers(32, 8);
+  assertDissolveCovers(128, 8);
+  assertDissolveCovers(64, 16);
+  assertDissolveCovers(17, 8);
+}
+
+void test_wipe_sweeps_from_the_left(void)
+{
+  const int16_t width = 72;
+  FrameLayer from(width, 8), to(width, 8), out(width, 8);
+  from.fillScreen(1);
+  for (int16_t y = 0; y < 8; y++)
+  {
+    to.drawPixel(y * 9, y, 1);
+  }
+  Transition transition(from, to, out);
+  transition.begin(TRANSITION_WIPE);
+  for (uint8_t frame = 0; frame < TRANSITION_FRAMES; frame++)
+  {
+    int16_t edge = width * frame / TRANSITION_FRAMES;
+    for (int16_t y = 0; y < 8; y++)
+    {
+      for (int16_t x = 0; x < width; x++)
+      {
+        TEST_ASSERT_EQUAL(x < edge ? pixel(to, x, y) : pixel(from, x, y), pixel(out, x, y));
+      }
+    }
+    TEST_ASSERT_EQUAL(frame + 1 < TRANSITION_FRAMES, transition.step());
+  }
+  TEST_ASSERT_EQUAL(litPixels(to), litPixels(out));
+  TEST_ASSERT_EQUAL(8, litPixels(out));
+}
+
+void test_slide_rolls_only_changed_characters(void)
+{
+  FrameLayer from(40, 8), to(40, 8), out(40, 8);
+  fill(from, 2, 0, 3, 4); // Changes: top half to bottom half
+  fill(to, 2, 4, 3, 4);
+  fill(from, 10, 0, 3, 8); // Unchanged
+  fill(to, 10, 0, 3, 8);
+  fill(from, 20, 2, 2, 3); // Disappears
+  fill(to, 30, 1, 2, 5);   // Appears
+
+  Transition transition(from, to, out);
+  transition.begin(TRANSITION_SLIDE);
+  for (uint8_t frame = 0; frame < TRANSITION_FRAMES; frame++)
+  {
+    int16_t offset = 8 * frame / TRANSITION_FRAMES;
+    for (int16_t y = 0; y < 8; y++)
+    {
+      for (int16_t x = 0; x < 40; x++)
+      {
+        bool rolls = (x >= 2 && x < 5) || (x >= 20 && x < 22) || (x >= 30 && x < 32);
+        bool expected = pixel(to, x, y);
+        if (rolls)
+        {
+          expected = (y + offset < 8) ? pixel(from, x, y + offset) : pixel(to, x, y + offset - 8);
+        }
+        char message[32];
+        snprintf(message, sizeof(message), "frame %d, pixel %d,%d", frame, x, y);
+        TEST_ASSERT_EQUAL_MESSAGE(expected, pixel(out, x, y), message);
+      }
+    }
+    transition.step();
+  }
+  TEST_ASSERT_FALSE(transition.isRunning());
+  for (int16_t y = 0; y < 8; y++)
+  {
+    TEST_ASSERT_EQUAL_HEX32(to.row(y)[0], out.row(y)[0]);
+    TEST_ASSERT_EQUAL_HEX32(to.row(y)[1], out.row(y)[1]);
+  }
+}
+
+void test_cut_shows_the_new_frame_at_once(void)
+{
+  FrameLayer from(32, 8), to(32, 8), out(32, 8);
+  from.fillScreen(1);
+  to.drawPixel(5, 5, 1);
+  Transition transition(from, to, out);
+  transition.begin(TRANSITION_CUT);
+  TEST_ASSERT_FALSE(transition.isRunning());
+  TEST_ASSERT_EQUAL(1, litPixels(out));
+  TEST_ASSERT_FALSE(transition.step());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_dissolve_reaches_every_pixel_for_each_lfsr_size);
+  RUN_TEST(test_dissolve_on_panel_sizes);
+  RUN_TEST(test_wipe_sweeps_from_the_left);
+  RUN_TEST(test_slide_rolls_only_changed_characters);
+  RUN_TEST(test_cut_shows_the_new_frame_at_once);
+  return UNITY_END();
+}
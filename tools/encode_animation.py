@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""Encode a text-art animation into the clock's binary .anim format.
+
+Input: frames of 8 rows drawn with '#' (lit) and '.' (dark), each frame
+introduced by a line "= <duration ms>". Optional "loops <n>" line first.
+
+    loops 4
+    = 500
+    ..##.##..
+    .#..#..#.
+    ...
+
+Usage: encode_animation.py heart.txt heart.anim
+Upload: curl -u admin:mqtt-clock-web -F "file=@heart.anim" http://<clock>/animations
+"""
+import sys
+
+TICK_MS = 10
+
+
+def parse(text):
+    loops, frames = 1, []
+    for line in text.splitlines():
+        line = line.strip()
+        if not line or line.startswith(";"):
+            continue
+        if line.startswith("loops"):
+            loops = int(line.split()[1])
+        elif line.startswith("="):
+            frames.append((int(line[1:]), []))
+        else:
+            frames[-1][1].append(line)
+    return loops, frames
+
+
+def columns(rows, width):
+    cols = []
+    for x in range(width):
+        bits = 0
+        for y, row in enumerate(rows[:8]):
+            if x < len(row) and row[x] == "#":
+                bits |= 1 << y
+        cols.append(bits)
+    return cols
+
+
+def encode_frame(prev, cur):
+    out, i, width = bytearray(), 0, len(cur)
+    while i < width:
+        if cur[i] == prev[i]:
+            n = 1
+            while i + n < width and n < 64 and cur[i + n] == prev[i + n]:
+                n += 1
+            out.append(n - 1)
+        else:
+            n = 1
+            while i + n < width and n < 64 and cur[i + n] == cur[i]:
+                n += 1
+            if n >= 3:
+                out += bytes([0x40 | (n - 1), cur[i]])
+            else:
+                n = 1
+                # A single unchanged column between changes is cheaper inside
+                # the literal than as its own keep op.
+                while i + n < width and n < 128 and (
+                        cur[i + n] != prev[i + n] or
+                        (i + n + 1 < width and n < 127 and cur[i + n + 1] != prev[i + n + 1])):
+                    n += 1
+                out.append(0x80 | (n - 1))
+                out += bytes(cur[i:i + n])
+        i += n
+    return out
+
+
+def encode(loops, frames):
+    """frames: list of (duration_ms, column bytes), all the same width."""
+    if not frames:
+        sys.exit("no frames: each frame starts with a line \"= <duration ms>\"")
+    width = len(frames[0][1])
+    # The header and the duration are one byte each; refuse anything that
+    # would not fit rather than play it differently from the drawing.
+    if not 1 <= width <= 255:
+        sys.exit("width %d columns: must be 1-255" % width)
+    if not 0 <= loops <= 255:
+        sys.exit("loops %d: must be 0-255" % loops)
+    out = bytearray(b"AN") + bytes([width, loops])
+    prev = [0] * width
+    for number, (duration, cols) in enumerate(frames, 1):
+        ticks = round(duration / TICK_MS)
+        if not 1 <= ticks <= 255:
+            sys.exit("frame %d: duration %d ms must be %d-%d ms"
+                     % (number, duration, TICK_MS, 255 * TICK_MS))
+        out.append(ticks)
+        out += encode_frame(prev, cols)
+        prev = cols
+    return bytes(out)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    loops, frames = parse(open(sys.argv[1]).read())
+    width = max((len(row) for _, rows in frames for row in rows), default=0)
+    data = encode(loops, [(d, columns(rows, width)) for d, rows in frames])
+    open(sys.argv[2], "wb").write(data)
+    print("%d frames, %d columns, %d bytes" % (len(frames), width, len(data)))
+
+
+if __name__ == "__main__":
+    main()